@@ -0,0 +1,349 @@
+#include "DatabaseBench.h"
+#include "kits/database/CppBatis.h"
+#include "kits/database/DatabaseManager.h"
+#include "kits/orm/TableStructs.h"
+#include "kits/required/config/ConfigService.h"
+#include "kits/required/log/CRossLogger.h"
+#include "kits/serialization/PointCloudCodec.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace _Controllers
+{
+    using namespace _Kits;
+    namespace
+    {
+        using Clock = std::chrono::steady_clock;
+
+        // 由序号得到均匀分布的伪随机数，各线程无需共享随机数状态
+        uint64_t mix(uint64_t x)
+        {
+            x += 0x9e3779b97f4a7c15ULL;
+            x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+            x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+            return x ^ (x >> 31);
+        }
+
+        radar_data benchRow(uint64_t seq)
+        {
+            static const QByteArray points = PointCloudCodec::encode(std::vector<RadarPoint>{{1.0f, 2.0f}, {3.0f, 4.0f}});
+            radar_data data;
+            data.location_id = static_cast<int>(seq & 0x7fffffff);
+            data.task_id = DatabaseBench::kBenchTaskId;
+            data.points_bin = points;
+            return data;
+        }
+
+        int64_t percentile(const std::vector<int64_t> &sorted, double p)
+        {
+            if (sorted.empty())
+            {
+                return 0;
+            }
+            auto index = static_cast<std::size_t>(p * static_cast<double>(sorted.size() - 1) + 0.5);
+            return sorted[std::min(index, sorted.size() - 1)];
+        }
+    } // namespace
+
+    // 固定的一组工作线程，各轮测量复用：每轮新建线程会让连接停留在已退出的线程名下
+    class DatabaseBench::Workers
+    {
+      public:
+        explicit Workers(int count)
+        {
+            m_threads.reserve(count);
+            for (int t = 0; t < count; ++t)
+            {
+                m_threads.emplace_back([this, t]() { loop(t); });
+            }
+        }
+
+        ~Workers()
+        {
+            {
+                std::lock_guard locker(m_mutex);
+                m_stop = true;
+            }
+            m_start.notify_all();
+            for (auto &thread : m_threads)
+            {
+                thread.join();
+            }
+        }
+
+        // 由前 active 个线程执行 task(t)，全部完成后返回
+        void run(int active, const std::function<void(int)> &task)
+        {
+            std::unique_lock locker(m_mutex);
+            m_task = &task;
+            m_active = active;
+            m_pending = active;
+            ++m_round;
+            m_start.notify_all();
+            m_finished.wait(locker, [this] { return m_pending == 0; });
+            m_task = nullptr;
+        }
+
+      private:
+        void loop(int t)
+        {
+            uint64_t seen = 0;
+            for (;;)
+            {
+                const std::function<void(int)> *task = nullptr;
+                {
+                    std::unique_lock locker(m_mutex);
+                    m_start.wait(locker, [&] { return m_stop || m_round != seen; });
+                    if (m_stop)
+                    {
+                        return;
+                    }
+                    seen = m_round;
+                    if (t >= m_active)
+                    {
+                        continue;
+                    }
+                    task = m_task;
+                }
+                (*task)(t);
+                std::lock_guard locker(m_mutex);
+                if (--m_pending == 0)
+                {
+                    m_finished.notify_one();
+                }
+            }
+        }
+
+        std::mutex m_mutex;
+        std::condition_variable m_start;
+        std::condition_variable m_finished;
+        const std::function<void(int)> *m_task = nullptr;
+        uint64_t m_round = 0;
+        int m_active = 0;
+        int m_pending = 0;
+        bool m_stop = false;
+        std::vector<std::thread> m_threads;
+    };
+
+    DatabaseBench::DatabaseBench(DatabaseBenchOptions options)
+        : m_options(std::move(options))
+    {
+    }
+
+    Json::Value DatabaseBench::run()
+    {
+        static const std::vector<std::pair<QString, Op>> scenarios{
+            {"single_insert", &DatabaseBench::singleInsert},
+            {"batch_insert", &DatabaseBench::batchInsert},
+            {"select_by_id", &DatabaseBench::selectById},
+            {"range_scan", &DatabaseBench::rangeScan},
+            {"batis_select", &DatabaseBench::batisSelect},
+            {"pool_contention", &DatabaseBench::poolContention},
+        };
+
+        Json::Value root;
+        {
+            DBConnectionGuard guard;
+            root["driver"] = guard.get().driverName().toStdString();
+        }
+        root["duration_ms"] = m_options.durationMs;
+        m_poolMax = ConfigService::instance().snapshot()->database.maxConnections;
+        root["pool_max_connections"] = m_poolMax;
+        root["results"] = Json::arrayValue;
+        if (!seed())
+        {
+            root["error"] = "seed rows failed, database not ready?";
+            cleanup();
+            return root;
+        }
+        int maxThreads = 1;
+        for (int threads : m_options.threads)
+        {
+            maxThreads = std::max(maxThreads, threads);
+        }
+        if (maxThreads > m_poolMax)
+        {
+            LogWarn("bench: up to {} threads against a pool of {} connections, higher levels measure pool queueing",
+                    maxThreads,
+                    m_poolMax);
+        }
+        Workers workers(maxThreads);
+        for (const auto &[name, op] : scenarios)
+        {
+            const auto &only = m_options.scenarios;
+            if (!only.empty() && std::find(only.begin(), only.end(), name) == only.end())
+            {
+                continue;
+            }
+            for (int threads : m_options.threads)
+            {
+                root["results"].append(measure(workers, name, op, std::max(threads, 1)));
+            }
+        }
+        cleanup();
+        return root;
+    }
+
+    Json::Value DatabaseBench::measure(Workers &workers, const QString &scenario, Op op, int threads)
+    {
+        const auto poolBefore = DatabaseManager::poolStats();
+        std::vector<std::vector<int64_t>> latencies(threads);
+        std::vector<uint64_t> rows(threads, 0);
+        std::atomic<uint64_t> errors{0};
+
+        const auto start = Clock::now();
+        workers.run(threads, [&](int t) {
+            const auto end = Clock::now() + std::chrono::milliseconds(m_options.durationMs);
+            auto &samples = latencies[t];
+            samples.reserve(4096);
+            for (uint64_t i = 0;; ++i)
+            {
+                const auto begin = Clock::now();
+                if (begin >= end)
+                {
+                    break;
+                }
+                const int n = (this->*op)((static_cast<uint64_t>(t) << 32) | i);
+                samples.push_back(std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - begin).count());
+                if (n < 0)
+                {
+                    ++errors;
+                    continue;
+                }
+                rows[t] += n;
+            }
+        });
+        const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        const auto poolAfter = DatabaseManager::poolStats();
+
+        std::vector<int64_t> all;
+        uint64_t totalRows = 0;
+        for (int t = 0; t < threads; ++t)
+        {
+            all.insert(all.end(), latencies[t].begin(), latencies[t].end());
+            totalRows += rows[t];
+        }
+        std::sort(all.begin(), all.end());
+
+        Json::Value result;
+        result["scenario"] = scenario.toStdString();
+        result["threads"] = threads;
+        result["ops"] = Json::UInt64(all.size());
+        result["errors"] = Json::UInt64(errors.load());
+        result["ops_per_sec"] = seconds > 0 ? all.size() / seconds : 0.0;
+        result["rows_per_sec"] = seconds > 0 ? totalRows / seconds : 0.0;
+        result["p50_us"] = Json::Int64(percentile(all, 0.50));
+        result["p99_us"] = Json::Int64(percentile(all, 0.99));
+        result["max_us"] = Json::Int64(all.empty() ? 0 : all.back());
+        result["pool_waits"] = Json::UInt64(poolAfter.waits - poolBefore.waits);
+        result["pool_timeouts"] = Json::UInt64(poolAfter.timeouts - poolBefore.timeouts);
+        result["pool_limited"] = threads > m_poolMax;
+        LogInfo("bench {} x{}: {} ops, {} errors, {:.0f} ops/s, p50 {} us, p99 {} us",
+                scenario.toStdString(),
+                threads,
+                all.size(),
+                errors.load(),
+                result["ops_per_sec"].asDouble(),
+                result["p50_us"].asInt64(),
+                result["p99_us"].asInt64());
+        return result;
+    }
+
+    bool DatabaseBench::seed()
+    {
+        // 读场景需要固定的 id 区间，先分批写入 seedRows 行
+        const int chunk = 1000;
+        for (int done = 0; done < m_options.seedRows; done += chunk)
+        {
+            std::vector<radar_data> lvObj;
+            const int count = std::min(chunk, m_options.seedRows - done);
+            lvObj.reserve(count);
+            for (int i = 0; i < count; ++i)
+            {
+                lvObj.push_back(benchRow(done + i));
+            }
+            SqlInsert<radar_data> insert;
+            if (!insert.insert(lvObj).exec())
+            {
+                return false;
+            }
+        }
+        auto range = CppBatis().execSql(
+            QString("SELECT MIN(id) AS min_id, MAX(id) AS max_id FROM radar_data WHERE task_id = %1").arg(kBenchTaskId));
+        if (range.isEmpty())
+        {
+            return false;
+        }
+        const auto record = range.front().toMap();
+        m_minId = record.value("min_id").toLongLong();
+        m_maxId = record.value("max_id").toLongLong();
+        return m_maxId >= m_minId && m_maxId > 0;
+    }
+
+    void DatabaseBench::cleanup()
+    {
+        auto result = CppBatis().execSql(QString("DELETE FROM radar_data WHERE task_id = %1").arg(kBenchTaskId));
+        if (!result.isEmpty())
+        {
+            LogInfo("bench cleanup: {} rows removed", result.front().toMap().value("rowsAffected").toLongLong());
+        }
+    }
+
+    int DatabaseBench::singleInsert(uint64_t seq)
+    {
+        SqlInsert<radar_data> insert;
+        return insert.insert(benchRow(seq)).exec() ? 1 : -1;
+    }
+
+    int DatabaseBench::batchInsert(uint64_t seq)
+    {
+        std::vector<radar_data> lvObj;
+        lvObj.reserve(m_options.batchSize);
+        for (int i = 0; i < m_options.batchSize; ++i)
+        {
+            lvObj.push_back(benchRow(seq + i));
+        }
+        SqlInsert<radar_data> insert;
+        return insert.insert(lvObj).exec() ? m_options.batchSize : -1;
+    }
+
+    int DatabaseBench::selectById(uint64_t seq)
+    {
+        const qint64 id = m_minId + static_cast<qint64>(mix(seq) % static_cast<uint64_t>(m_maxId - m_minId + 1));
+        SqlSelect<radar_data> select;
+        select.where("id", OperatorComparison::Equal, id);
+        return select.exec() ? static_cast<int>(select.getResults().size()) : -1;
+    }
+
+    int DatabaseBench::rangeScan(uint64_t seq)
+    {
+        const qint64 id = m_minId + static_cast<qint64>(mix(seq) % static_cast<uint64_t>(m_maxId - m_minId + 1));
+        SqlSelect<radar_data> select;
+        select.after(id - 1).limit(m_options.rangeSize);
+        return select.exec() ? static_cast<int>(select.getResults().size()) : -1;
+    }
+
+    int DatabaseBench::batisSelect(uint64_t seq)
+    {
+        const qint64 id = m_minId + static_cast<qint64>(mix(seq) % static_cast<uint64_t>(m_maxId - m_minId + 1));
+        auto result = CppBatis().execColumnar(QString("SELECT id, location_id, points_bin FROM radar_data WHERE id = %1").arg(id));
+        return result.ok ? static_cast<int>(result.rows) : -1;
+    }
+
+    int DatabaseBench::poolContention(uint64_t)
+    {
+        // 每次都归还连接，测量连接池取还与等待的开销
+        DBConnectionGuard guard;
+        if (!guard.get().isOpen())
+        {
+            return -1;
+        }
+        QSqlQuery query(guard.get());
+        return query.exec("SELECT 1") ? 1 : -1;
+    }
+} // namespace _Controllers
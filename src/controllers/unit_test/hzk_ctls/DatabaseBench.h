@@ -0,0 +1,63 @@
+#pragma once
+#include <QString>
+#include <cstdint>
+#include <json/json.h>
+#include <vector>
+
+namespace _Controllers
+{
+    // 数据库基准的运行参数
+    struct DatabaseBenchOptions
+    {
+        std::vector<int> threads{1, 4, 16, 64}; // 依次测试的并发线程数
+        int durationMs = 2000;                  // 每个场景每个并发度的持续时间
+        int batchSize = 100;                    // batch_insert 每次写入的行数
+        int rangeSize = 100;                    // range_scan 每次读取的行数
+        int seedRows = 10000;                   // 读场景前预先写入的行数
+        std::vector<QString> scenarios;         // 为空表示全部场景
+    };
+
+    /**
+     * @brief 数据库基准：对当前配置的数据库（建议指向本地 PostgreSQL）测量各访问路径在并发下的延迟与吞吐。
+     *
+     * 场景：single_insert、batch_insert（SqlInsert）、select_by_id、range_scan（SqlSelect）、
+     * batis_select（CppBatis）、pool_contention（取还连接并执行 SELECT 1）。
+     * 每个场景在每个并发度下各线程持续执行 durationMs；工作线程按最大并发度一次创建、各轮复用，
+     * 连接始终归属存活的线程。并发度超过连接池上限时结果带 pool_limited，此时测到的是排队等待。结果为 JSON：
+     * @code
+     * {"driver":"QPSQL","duration_ms":2000,"pool_max_connections":16,"results":[{"scenario":"select_by_id","threads":16,
+     *   "ops":..,"errors":0,"ops_per_sec":..,"rows_per_sec":..,"p50_us":..,"p99_us":..,"max_us":..,
+     *   "pool_waits":..,"pool_timeouts":..,"pool_limited":false}]}
+     * @endcode
+     * 写入的行 task_id 为 kBenchTaskId，结束后删除。
+     */
+    class DatabaseBench
+    {
+      public:
+        static constexpr int kBenchTaskId = -9;
+
+        explicit DatabaseBench(DatabaseBenchOptions options);
+        Json::Value run();
+
+      private:
+        // 单次操作，返回处理的行数，失败返回 -1
+        using Op = int (DatabaseBench::*)(uint64_t seq);
+        class Workers;
+
+        Json::Value measure(Workers &workers, const QString &scenario, Op op, int threads);
+        bool seed();
+        void cleanup();
+
+        int singleInsert(uint64_t seq);
+        int batchInsert(uint64_t seq);
+        int selectById(uint64_t seq);
+        int rangeScan(uint64_t seq);
+        int batisSelect(uint64_t seq);
+        int poolContention(uint64_t seq);
+
+        DatabaseBenchOptions m_options;
+        qint64 m_minId = 0; // 预写入行的 id 区间，读场景在其中随机取
+        qint64 m_maxId = 0;
+        int m_poolMax = 0; // 本次运行时连接池的连接上限
+    };
+} // namespace _Controllers
@@ -1,7 +1,10 @@
 #include "DeviceInfoController.h"
+#include "kits/database/DeviceStatusStore.h"
 #include "kits/required/log/CRossLogger.h"
 #include "service/AppFramework.h"
+#include "tis_global/Field.h"
 #include "tis_global/Function.h"
+#include <QJsonDocument>
 #include <qglobal.h>
 #include <qlogging.h>
 #include <qvariant.h>
@@ -12,6 +15,12 @@ using namespace _Service;
 void DeviceInfoController::doDiskInfo(const QVariant &data)
 {
     _Kits::LogInfo("recv doDiskInfo");
+    // 磁盘信息每 5 s 采样一次，只有变化时才写入 device_status
+    const auto disk = data.toMap().value(TIS_Info::QmlCommunication::strData).toMap();
+    if (!disk.isEmpty())
+    {
+        deviceStatus().report("disk", QString::fromUtf8(QJsonDocument::fromVariant(disk).toJson(QJsonDocument::Compact)));
+    }
     auto res = App().invokeModuleAsync(TIS_Info::QmlPrivateEngine::testArgs, (int)0, std::string("123"), (float)4);
     auto str = App().invokeModuleSync<std::string>(TIS_Info::QmlPrivateEngine::testArgs, (int)0, std::string("789"), (float)4);
     _Kits::LogInfo("recv doDiskInfo end = {},{}", res, str.c_str());
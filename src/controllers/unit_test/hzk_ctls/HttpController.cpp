@@ -1,12 +1,371 @@
 #include "HttpController.h"
+#include "DatabaseBench.h"
+#include "LogBench.h"
+#include "kits/database/DatabaseExecutor.h"
+#include "kits/database/DeviceStatusStore.h"
+#include "kits/database/PreparedStatementCache.h"
+#include "kits/database/QueryResultCache.h"
+#include "kits/database/WriteBehind.h"
+#include "kits/orm/OrmMapperImpl.h"
+#include "kits/required/config/ConfigService.h"
+#include "kits/required/factory/StartupRegister.h"
 #include "kits/required/log/CRossLogger.h"
-#include <chrono>
+#include "kits/required/log/JsonLogQuery.h"
+#include <QUrlQuery>
+#include <algorithm>
+#include <map>
+#include <sstream>
+#include <json/json.h>
 
 using namespace _Controllers;
 using namespace _Kits;
+namespace
+{
+    // /database/select 可查询的表与列，表名、列名只从这里取，不拼接请求中的文本
+    template <typename T>
+    std::pair<QString, QStringList> selectable()
+    {
+        return {T::tableName(), QStringList{QStringLiteral("id")} + OrmMapper<T>::valueColumns()};
+    }
+
+    const std::map<QString, QStringList> &selectableTables()
+    {
+        static const std::map<QString, QStringList> tables{
+            selectable<device_status>(),
+            selectable<mvb_line_data>(),
+            selectable<location_data>(),
+            selectable<radar_data>(),
+            selectable<radar_over_data>(),
+            selectable<task_data>(),
+            selectable<line_data>(),
+            selectable<arc_data>(),
+        };
+        return tables;
+    }
+
+    QHttpServerResponse jsonError(QHttpServerResponse::StatusCode status, const QString &message)
+    {
+        Json::Value root;
+        root["error"] = message.toStdString();
+        Json::StreamWriterBuilder builder;
+        builder["indentation"] = "";
+        return QHttpServerResponse("application/json", QByteArray::fromStdString(Json::writeString(builder, root)), status);
+    }
+
+    // 压测路由会写入业务表并占满连接池与执行器：须在配置中显式开启（app.bench_routes），且只接受本机请求
+    bool benchAllowed(const QHttpServerRequest &req)
+    {
+        return ConfigService::instance().snapshot()->benchRoutes && req.remoteAddress().isLoopback();
+    }
+} // namespace
+
+// GET /database/select?table=radar_data&columns=id,task_id&task_id=3&from=<epoch ms>&to=<epoch ms>&after=<id>&limit=1000
+//     &format=json|cbor&timeout_ms=10000
+// 只按白名单中的表与列查询：其余查询参数须为列名，作为相等条件；from/to 为 created_time 的 [from, to)，
+// after 为 id 下界（不含），结果按 id 升序，limit 默认 1000、最大 10000。条件值一律以参数绑定。
+// 结果为列式：{"columns":[..],"types":[..],"rows":n,"data":[[第一列..],[第二列..]]}
 QHttpServerResponse HttpController::onSelect(const QHttpServerRequest &req)
 {
-    _Kits::LogInfo("recv onSelect");
-    std::this_thread::sleep_for(std::chrono::seconds(5));
-    return QHttpServerResponse(req.body());
+    static const QStringList reserved{"table", "columns", "from", "to", "after", "limit", "format", "timeout_ms"};
+    constexpr int kMaxRows = 10000;
+    const QUrlQuery params = req.query();
+    const bool cbor = params.queryItemValue("format") == "cbor" ||
+                      req.headers().value(QHttpHeaders::WellKnownHeader::Accept).contains("application/cbor");
+    const int timeoutMs = params.hasQueryItem("timeout_ms") ? params.queryItemValue("timeout_ms").toInt() : 10000;
+
+    const auto &tables = selectableTables();
+    const auto table = tables.find(params.queryItemValue("table"));
+    if (table == tables.end())
+    {
+        return jsonError(QHttpServerResponse::StatusCode::BadRequest, "unknown table");
+    }
+    const auto &known = table->second;
+    QStringList columns = params.queryItemValue("columns").split(',', Qt::SkipEmptyParts);
+    for (const auto &column : columns)
+    {
+        if (!known.contains(column))
+        {
+            return jsonError(QHttpServerResponse::StatusCode::BadRequest, "unknown column: " + column);
+        }
+    }
+    if (columns.isEmpty())
+    {
+        columns = known;
+    }
+
+    QStringList conditions;
+    QVariantList values;
+    for (const auto &[key, value] : params.queryItems(QUrl::FullyDecoded))
+    {
+        if (reserved.contains(key))
+        {
+            continue;
+        }
+        if (!known.contains(key))
+        {
+            return jsonError(QHttpServerResponse::StatusCode::BadRequest, "unknown column: " + key);
+        }
+        conditions << QString("%1 = ?").arg(key);
+        values << value;
+    }
+    if (params.hasQueryItem("from"))
+    {
+        conditions << QStringLiteral("created_time >= ?");
+        values << QDateTime::fromMSecsSinceEpoch(params.queryItemValue("from").toLongLong());
+    }
+    if (params.hasQueryItem("to"))
+    {
+        conditions << QStringLiteral("created_time < ?");
+        values << QDateTime::fromMSecsSinceEpoch(params.queryItemValue("to").toLongLong());
+    }
+    if (params.hasQueryItem("after"))
+    {
+        conditions << QStringLiteral("id > ?");
+        values << params.queryItemValue("after").toLongLong();
+    }
+    const int limit = params.hasQueryItem("limit") ? std::clamp(params.queryItemValue("limit").toInt(), 1, kMaxRows) : 1000;
+    values << limit;
+
+    QString sql = QString("SELECT %1 FROM %2").arg(columns.join(", "), table->first);
+    if (!conditions.isEmpty())
+    {
+        sql.append(" WHERE ").append(conditions.join(" AND "));
+    }
+    sql.append(" ORDER BY id LIMIT ?");
+
+    ColumnarResult result;
+    try
+    {
+        auto future = dbExecutor().submit([sql, values]() { return CppBatis().execColumnar(sql, values); }, timeoutMs);
+        future.waitForFinished();
+        result = future.result();
+    }
+    catch (const DatabaseTaskError &e)
+    {
+        return jsonError(QHttpServerResponse::StatusCode::ServiceUnavailable, e.what());
+    }
+    if (!result.ok)
+    {
+        return jsonError(QHttpServerResponse::StatusCode::BadRequest, result.error);
+    }
+    LogDebug("select {} rows x {} columns from {}", result.rows, result.columns.size(), table->first.toStdString());
+    return cbor ? QHttpServerResponse("application/cbor", result.toCbor()) : QHttpServerResponse("application/json", result.toJson());
+}
+
+// GET /log/query?from=<epoch ms>&to=<epoch ms>&level=warn&limit=500
+// from、to 均含端点：to 对应的那一毫秒内的日志也会返回
+QHttpServerResponse HttpController::onLogQuery(const QHttpServerRequest &req)
+{
+    const auto &directory = CRossLogger::getLogger().getJsonLogDirectory();
+    if (directory.empty())
+    {
+        return QHttpServerResponse(QHttpServerResponse::StatusCode::NotFound);
+    }
+    const QUrlQuery query = req.query();
+    JsonLogFilter filter;
+    if (query.hasQueryItem("from"))
+    {
+        filter.fromUs = query.queryItemValue("from").toLongLong() * 1000;
+    }
+    if (query.hasQueryItem("to"))
+    {
+        filter.toUs = query.queryItemValue("to").toLongLong() * 1000 + 999;
+    }
+    if (query.hasQueryItem("level"))
+    {
+        filter.minLevel = spdlog::level::from_str(query.queryItemValue("level").toStdString());
+    }
+    if (query.hasQueryItem("limit"))
+    {
+        filter.limit = query.queryItemValue("limit").toULongLong();
+    }
+    auto body = JsonLogQuery(directory).queryAsJsonArray(filter);
+    return QHttpServerResponse("application/json", QByteArray::fromStdString(body));
+}
+
+// POST /log/bench?lines=1000000&message_bytes=100&buffer_kb=256
+// 需开启 app.bench_routes 且从本机访问；在临时目录对比 PlainTextSink 与 spdlog 基础文件 sink 的单线程写入吞吐
+QHttpServerResponse HttpController::onLogBench(const QHttpServerRequest &req)
+{
+    if (!benchAllowed(req))
+    {
+        return QHttpServerResponse(QHttpServerResponse::StatusCode::Forbidden);
+    }
+    const QUrlQuery params = req.query();
+    LogBenchOptions options;
+    if (params.hasQueryItem("lines"))
+    {
+        options.lines = std::clamp(params.queryItemValue("lines").toInt(), 1, 50000000);
+    }
+    if (params.hasQueryItem("message_bytes"))
+    {
+        options.messageBytes = std::clamp(params.queryItemValue("message_bytes").toInt(), 0, 4096);
+    }
+    if (params.hasQueryItem("buffer_kb"))
+    {
+        options.bufferKb = std::clamp(params.queryItemValue("buffer_kb").toInt(), 4, 16384);
+    }
+
+    auto root = LogBench(options).run();
+    Json::StreamWriterBuilder builder;
+    builder["indentation"] = "";
+    return QHttpServerResponse("application/json", QByteArray::fromStdString(Json::writeString(builder, root)));
+}
+
+// GET /database/stats 连接池、语句缓存、结果缓存与写后落库统计
+QHttpServerResponse HttpController::onDatabaseStats(const QHttpServerRequest &)
+{
+    Json::Value root;
+    auto pool = DatabaseManager::poolStats();
+    auto &jsPool = root["pool"];
+    jsPool["hits"] = Json::UInt64(pool.hits);
+    jsPool["waits"] = Json::UInt64(pool.waits);
+    jsPool["creations"] = Json::UInt64(pool.creations);
+    jsPool["timeouts"] = Json::UInt64(pool.timeouts);
+    jsPool["evictions"] = Json::UInt64(pool.evictions);
+    jsPool["ping_failures"] = Json::UInt64(pool.pingFailures);
+    jsPool["total"] = pool.total;
+    jsPool["idle"] = pool.idle;
+    jsPool["waiting"] = pool.waiting;
+
+    auto statements = PreparedStatementCache::stats();
+    auto &jsStatements = root["statement_cache"];
+    jsStatements["hits"] = Json::UInt64(statements.hits);
+    jsStatements["misses"] = Json::UInt64(statements.misses);
+    jsStatements["evictions"] = Json::UInt64(statements.evictions);
+    jsStatements["bypasses"] = Json::UInt64(statements.bypasses);
+
+    auto results = QueryResultCache::instance().stats();
+    auto &jsResults = root["result_cache"];
+    jsResults["hits"] = Json::UInt64(results.hits);
+    jsResults["misses"] = Json::UInt64(results.misses);
+    jsResults["evictions"] = Json::UInt64(results.evictions);
+    jsResults["invalidations"] = Json::UInt64(results.invalidations);
+    jsResults["entries"] = Json::UInt64(results.entries);
+    jsResults["bytes"] = Json::UInt64(results.bytes);
+
+    auto &jsWrite = root["write_behind"];
+    jsWrite["backpressure_waits"] = Json::UInt64(writeBehind().backpressureWaits());
+    jsWrite["offline"] = writeBehind().isOffline();
+    for (const auto &[table, stats] : writeBehind().stats())
+    {
+        auto &jsTable = jsWrite["tables"][table];
+        jsTable["queued"] = Json::UInt64(stats.queued);
+        jsTable["flushed"] = Json::UInt64(stats.flushed);
+        jsTable["spilled"] = Json::UInt64(stats.spilled);
+        jsTable["replayed"] = Json::UInt64(stats.replayed);
+        jsTable["rejected"] = Json::UInt64(stats.rejected);
+        jsTable["batches"] = Json::UInt64(stats.batches);
+        jsTable["failures"] = Json::UInt64(stats.failures);
+        jsTable["pending"] = Json::UInt64(stats.pending);
+        jsTable["max_batch"] = Json::UInt64(stats.maxBatch);
+        jsTable["avg_batch"] = stats.batches ? double(stats.flushed) / stats.batches : 0.0;
+        jsTable["last_flush_us"] = Json::Int64(stats.lastFlushUs);
+        jsTable["max_flush_us"] = Json::Int64(stats.maxFlushUs);
+        jsTable["avg_flush_us"] = stats.batches ? Json::Int64(stats.totalFlushUs / int64_t(stats.batches)) : Json::Int64(0);
+    }
+
+    auto devices = deviceStatus().stats();
+    auto &jsDevices = root["device_status"];
+    jsDevices["reported"] = Json::UInt64(devices.reported);
+    jsDevices["changed"] = Json::UInt64(devices.changed);
+    jsDevices["keyframes"] = Json::UInt64(devices.keyframes);
+    jsDevices["unchanged"] = Json::UInt64(devices.unchanged);
+
+    auto &jsStartup = root["startup_ms"];
+    for (const auto &[milestone, ms] : StartupRegister::getMilestones())
+    {
+        jsStartup[milestone] = Json::Int64(ms);
+    }
+    Json::StreamWriterBuilder builder;
+    builder["indentation"] = "";
+    return QHttpServerResponse("application/json", QByteArray::fromStdString(Json::writeString(builder, root)));
+}
+
+// POST /database/bench?threads=1,4,16,64&duration_ms=2000&batch=100&range=100&seed=10000&scenarios=select_by_id,range_scan
+// 需开启 app.bench_routes 且从本机访问；同步执行，耗时约 场景数 x 并发度数 x duration_ms；结果为 JSON，便于不同版本之间对比
+QHttpServerResponse HttpController::onDatabaseBench(const QHttpServerRequest &req)
+{
+    if (!benchAllowed(req))
+    {
+        return QHttpServerResponse(QHttpServerResponse::StatusCode::Forbidden);
+    }
+    const QUrlQuery params = req.query();
+    DatabaseBenchOptions options;
+    if (params.hasQueryItem("threads"))
+    {
+        options.threads.clear();
+        for (const auto &item : params.queryItemValue("threads").split(',', Qt::SkipEmptyParts))
+        {
+            options.threads.push_back(std::clamp(item.toInt(), 1, 256));
+        }
+    }
+    if (params.hasQueryItem("duration_ms"))
+    {
+        options.durationMs = std::max(params.queryItemValue("duration_ms").toInt(), 100);
+    }
+    if (params.hasQueryItem("batch"))
+    {
+        options.batchSize = std::max(params.queryItemValue("batch").toInt(), 1);
+    }
+    if (params.hasQueryItem("range"))
+    {
+        options.rangeSize = std::max(params.queryItemValue("range").toInt(), 1);
+    }
+    if (params.hasQueryItem("seed"))
+    {
+        options.seedRows = std::max(params.queryItemValue("seed").toInt(), 1);
+    }
+    for (const auto &item : params.queryItemValue("scenarios").split(',', Qt::SkipEmptyParts))
+    {
+        options.scenarios.push_back(item.trimmed());
+    }
+
+    auto root = DatabaseBench(std::move(options)).run();
+    Json::StreamWriterBuilder builder;
+    builder["indentation"] = "";
+    return QHttpServerResponse("application/json", QByteArray::fromStdString(Json::writeString(builder, root)));
+}
+
+// GET /device/status?tag=disk 设备最新状态，取自内存，不访问数据库；不带 tag 时返回全部
+QHttpServerResponse HttpController::onDeviceStatus(const QHttpServerRequest &req)
+{
+    const QUrlQuery params = req.query();
+    std::vector<device_status> states;
+    if (params.hasQueryItem("tag"))
+    {
+        if (auto status = deviceStatus().current(params.queryItemValue("tag")))
+        {
+            states.push_back(std::move(*status));
+        }
+        else
+        {
+            return QHttpServerResponse(QHttpServerResponse::StatusCode::NotFound);
+        }
+    }
+    else
+    {
+        states = deviceStatus().currentAll();
+    }
+
+    Json::Value root(Json::arrayValue);
+    Json::CharReaderBuilder reader;
+    for (const auto &status : states)
+    {
+        Json::Value item;
+        item["tag"] = status.tag.toStdString();
+        const auto details = status.details_json.toStdString();
+        std::string errors;
+        std::istringstream stream(details);
+        if (!Json::parseFromStream(reader, stream, &item["details"], &errors))
+        {
+            item["details"] = details;
+        }
+        item["since"] = status.created_time.toString(Qt::ISODateWithMs).toStdString();
+        item["updated"] = status.updated_time.toString(Qt::ISODateWithMs).toStdString();
+        root.append(std::move(item));
+    }
+    Json::StreamWriterBuilder builder;
+    builder["indentation"] = "";
+    return QHttpServerResponse("application/json", QByteArray::fromStdString(Json::writeString(builder, root)));
 }
@@ -6,8 +6,18 @@ namespace _Controllers
     {
       public:
         QHttpServerResponse onSelect(const QHttpServerRequest &);
+        QHttpServerResponse onLogQuery(const QHttpServerRequest &);
+        QHttpServerResponse onLogBench(const QHttpServerRequest &);
+        QHttpServerResponse onDatabaseStats(const QHttpServerRequest &);
+        QHttpServerResponse onDatabaseBench(const QHttpServerRequest &);
+        QHttpServerResponse onDeviceStatus(const QHttpServerRequest &);
         HTTP_LIST_BEGIN
         HTTP_ADD(TIS_Info::HttpService::HttpRoutes::database_select, HttpController::onSelect);
+        HTTP_ADD(TIS_Info::HttpService::HttpRoutes::log_query, HttpController::onLogQuery);
+        HTTP_ADD(TIS_Info::HttpService::HttpRoutes::log_bench, HttpController::onLogBench);
+        HTTP_ADD(TIS_Info::HttpService::HttpRoutes::database_stats, HttpController::onDatabaseStats);
+        HTTP_ADD(TIS_Info::HttpService::HttpRoutes::database_bench, HttpController::onDatabaseBench);
+        HTTP_ADD(TIS_Info::HttpService::HttpRoutes::device_status, HttpController::onDeviceStatus);
         HTTP_LIST_END
     };
 } // namespace _Controllers
@@ -0,0 +1,106 @@
+#include "LogBench.h"
+#include "kits/required/log/CRossLogger.h"
+#include "kits/required/log/PlainTextSink.h"
+#include <QCoreApplication>
+#include <QDir>
+#include <QDirIterator>
+#include <algorithm>
+#include <chrono>
+#include <spdlog/sinks/basic_file_sink.h>
+#include <string>
+#include <vector>
+
+namespace _Controllers
+{
+    using namespace _Kits;
+    namespace
+    {
+        using Clock = std::chrono::steady_clock;
+
+        // 目录下全部文件的总长度，即实际写出的字节数
+        qint64 directoryBytes(const QString &path)
+        {
+            qint64 bytes = 0;
+            QDirIterator it(path, QDir::Files, QDirIterator::Subdirectories);
+            while (it.hasNext())
+            {
+                bytes += it.nextFileInfo().size();
+            }
+            return bytes;
+        }
+    } // namespace
+
+    LogBench::LogBench(LogBenchOptions options)
+        : m_options(options)
+    {
+    }
+
+    Json::Value LogBench::run()
+    {
+        const QString root = QDir::temp().filePath(QString("tis_log_bench_%1").arg(QCoreApplication::applicationPid()));
+        const std::string pattern(CRossLogger::getLogger().getDefaultLogPattern());
+        const std::string message(static_cast<std::size_t>(m_options.messageBytes), 'x');
+        const std::size_t bufferSize = static_cast<std::size_t>(m_options.bufferKb) * 1024;
+        // 单文件上限取 1 GiB，避免按大小切换干扰测量
+        const std::size_t maxSize = std::size_t{1} << 30;
+
+        using SinkFactory = spdlog::sink_ptr (*)(const std::string &, std::size_t, std::size_t);
+        static const std::vector<std::pair<std::string, SinkFactory>> sinks{
+            {"plain_text_never",
+             [](const std::string &dir, std::size_t size, std::size_t buffer) -> spdlog::sink_ptr {
+                 return std::make_shared<PlainTextSink_st>(dir, size, LogSyncPolicy::never, buffer);
+             }},
+            {"plain_text_on_rotate",
+             [](const std::string &dir, std::size_t size, std::size_t buffer) -> spdlog::sink_ptr {
+                 return std::make_shared<PlainTextSink_st>(dir, size, LogSyncPolicy::on_rotate, buffer);
+             }},
+            {"spdlog_basic",
+             [](const std::string &dir, std::size_t, std::size_t) -> spdlog::sink_ptr {
+                 return std::make_shared<spdlog::sinks::basic_file_sink_st>(dir + "/basic.log", true);
+             }},
+        };
+
+        Json::Value result;
+        result["lines"] = m_options.lines;
+        result["message_bytes"] = m_options.messageBytes;
+        result["buffer_kb"] = m_options.bufferKb;
+        result["results"] = Json::arrayValue;
+        for (const auto &[name, factory] : sinks)
+        {
+            const QString dir = root + "/" + QString::fromStdString(name);
+            QDir().mkpath(dir);
+            int64_t elapsedUs = 1;
+            {
+                // 不注册到 spdlog 全局表，避免与正式日志器互相影响
+                spdlog::logger logger("log_bench", factory(dir.toStdString(), maxSize, bufferSize));
+                logger.set_pattern(pattern);
+                logger.set_level(spdlog::level::info);
+                const spdlog::source_loc location{__FILE__, __LINE__, "LogBench::run"};
+
+                const auto start = Clock::now();
+                for (int i = 0; i < m_options.lines; ++i)
+                {
+                    logger.log(location, spdlog::level::info, "bench line {} {}", i, message);
+                }
+                logger.flush();
+                elapsedUs = std::max<int64_t>(
+                    std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count(), 1);
+            }
+            // sink 析构时截断预分配区域，此时的文件长度才是实际写出的字节数
+            const auto bytes = directoryBytes(dir);
+            Json::Value item;
+            item["sink"] = name;
+            item["elapsed_ms"] = static_cast<Json::Int64>(elapsedUs / 1000);
+            item["lines_per_sec"] = static_cast<Json::Int64>(static_cast<double>(m_options.lines) * 1e6 / elapsedUs);
+            item["mb_per_sec"] = static_cast<double>(bytes) / (1024.0 * 1024.0) * 1e6 / elapsedUs;
+            item["file_bytes"] = static_cast<Json::Int64>(bytes);
+            LogInfo("log bench: {} {} lines/s, {:.1f} MB/s",
+                    name,
+                    item["lines_per_sec"].asInt64(),
+                    item["mb_per_sec"].asDouble());
+            result["results"].append(item);
+        }
+        QDir(root).removeRecursively();
+        return result;
+    }
+} // namespace _Controllers
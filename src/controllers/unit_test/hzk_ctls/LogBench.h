@@ -0,0 +1,36 @@
+#pragma once
+#include <cstdint>
+#include <json/json.h>
+
+namespace _Controllers
+{
+    // 日志基准的运行参数
+    struct LogBenchOptions
+    {
+        int lines = 1000000;   // 每个 sink 写入的行数
+        int messageBytes = 100; // 每行消息正文的长度（不含时间、位置等格式前缀）
+        int bufferKb = 256;     // PlainTextSink 用户态缓冲大小
+    };
+
+    /**
+     * @brief 日志基准：单线程经 spdlog::logger 向各文件 sink 写入固定行数，测量格式化 + 写文件的吞吐。
+     *
+     * 使用与正式日志相同的格式（CRossLogger::getDefaultLogPattern），写到临时目录，结束后删除。
+     * 对比项：plain_text_never / plain_text_on_rotate（PlainTextSink 不同落盘策略）与
+     * spdlog_basic（spdlog::sinks::basic_file_sink_st，作为基线）。计时包含最后一次 flush，
+     * 不含析构时的落盘与截断。结果为 JSON：
+     * @code
+     * {"lines":1000000,"message_bytes":100,"buffer_kb":256,"results":[{"sink":"plain_text_never",
+     *   "elapsed_ms":..,"lines_per_sec":..,"mb_per_sec":..,"file_bytes":..}]}
+     * @endcode
+     */
+    class LogBench
+    {
+      public:
+        explicit LogBench(LogBenchOptions options);
+        Json::Value run();
+
+      private:
+        LogBenchOptions m_options;
+    };
+} // namespace _Controllers
@@ -1,8 +1,14 @@
 #include "TestDatabase.h"
 #include "kits/database/CppBatis.h"
+#include "kits/database/DatabaseExecutor.h"
+#include "kits/database/PgPipeline.h"
+#include "kits/database/SqlCopy.h"
+#include "kits/database/SqlUpdate.h"
+#include "kits/database/SqlUpsert.h"
 #include "kits/orm/TableStructs.h"
 #include "kits/required/log/CRossLogger.h"
-#include <json/value.h>
+#include "kits/serialization/PointCloudCodec.h"
+#include <chrono>
 #include <qdebug.h>
 
 namespace _Controllers
@@ -12,6 +18,7 @@ namespace _Controllers
     {
         // insert();
         select();
+        selectAsync();
     }
     void TestDatabase::insert()
     {
@@ -22,13 +29,9 @@ namespace _Controllers
         for (int i = 0; i < batchSize; i++)
         {
             radar_data data;
-            Json::Value jsRoot;
-            Json::Value jsdata;
-            jsdata["x"] = i;
-            jsdata["y"] = i;
-            jsRoot["points"].append(jsdata);
+            std::vector<RadarPoint> points{{static_cast<float>(i), static_cast<float>(i)}};
             data.location_id = i;
-            data.points = jsRoot.toStyledString().c_str();
+            data.points_bin = PointCloudCodec::encode(points);
             lvObj.emplace_back(std::move(data));
         }
         _Kits::LogDebug("sql insert begin");
@@ -42,13 +45,182 @@ namespace _Controllers
 
         // 获取第1页，每页1条记录，按时间倒序，也就是获取最新的一条记录
         auto selector = _Kits::SqlSelect<radar_data>();
-        selector.select({"id", "points"}).where("id", OperatorComparison::LessThan, 1000).orderBy("id", false).paginate(1, 10).exec();
+        selector.select({"id", "points", "points_bin"}).where("id", OperatorComparison::LessThan, 1000).orderBy("id", false).paginate(1, 10).exec();
 
-        // 处理查询结果
+        // 处理查询结果，迁移未完成时旧行仍是 JSON 文本
         auto datas = selector.getResults();
+        std::vector<RadarPoint> points;
         for (const auto &data : datas)
         {
-            qDebug() << "id:" << data.id << data.points;
+            if (PointCloudCodec::load(data.points_bin, data.points, points))
+            {
+                qDebug() << "id:" << data.id << "points:" << points.size();
+            }
+        }
+
+        // 一次往返按一组 id 取回，同一字段上的区间条件互不覆盖
+        QVariantList ids;
+        for (int id = 1; id <= 1000; id++)
+        {
+            ids << id;
+        }
+        SqlSelect<radar_data> batch;
+        batch.select({"id", "task_id"})
+            .whereIn("id", ids)
+            .where("task_id", OperatorComparison::GreaterEqual, 1)
+            .where("task_id", OperatorComparison::LessThan, 100);
+        if (batch.exec())
+        {
+            qDebug() << "batch rows:" << batch.getResults().size();
+        }
+
+        // 参考表走结果缓存，写入 line_data 后自动失效
+        SqlSelect<line_data> lines;
+        lines.orderBy("id").cached();
+        if (lines.exec())
+        {
+            qDebug() << "line rows:" << lines.getResults().size();
+        }
+    }
+    void TestDatabase::selectAsync()
+    {
+        // 提交到数据库执行器，当前线程不等待查询结果
+        SqlSelect<radar_data> selector;
+        selector.select({"id", "points"}).orderBy("id", false).paginate(1, 10);
+        dbExecutor()
+            .select(std::move(selector), 3000)
+            .then([](const std::vector<radar_data> &datas) {
+                for (const auto &data : datas)
+                {
+                    qDebug() << "async id:" << data.id << data.points;
+                }
+            })
+            .onFailed([](const DatabaseTaskError &error) { LogWarn("async select failed: {}", error.what()); });
+    }
+    void TestDatabase::scan()
+    {
+        // 全表扫描：键集分页每页只取 1000 行，页内以只进游标逐行处理
+        qint64 last = 0;
+        qsizetype total = 0;
+        for (;;)
+        {
+            SqlSelect<radar_data> selector;
+            selector.select({"id", "task_id", "points"}).after(last).limit(1000);
+            auto rows = selector.stream();
+            for (auto &row : rows)
+            {
+                last = row.id;
+            }
+            if (rows.count() == 0)
+            {
+                break;
+            }
+            total += rows.count();
+        }
+        LogInfo("scan radar_data: {} rows, last id {}", total, last);
+    }
+    void TestDatabase::update()
+    {
+        // 按 tag 插入或更新设备状态，tag 须有唯一约束；一万条约十条语句
+        std::vector<device_status> states;
+        for (int i = 0; i < 10000; i++)
+        {
+            device_status status;
+            status.tag = QString("device_%1").arg(i % 200);
+            status.details_json = QString(R"({"seq":%1})").arg(i);
+            states.emplace_back(std::move(status));
+        }
+        SqlUpsert<device_status> upsert;
+        upsert.onConflict({"tag"}).upsert(states).exec();
+        LogInfo("upsert device_status: {} rows affected", upsert.getNumAffected());
+
+        // 按条件批量改写，不再先查后逐行更新
+        SqlUpdate<radar_data> update;
+        update.set("task_id", 2).where("task_id", OperatorComparison::Equal, 1).exec();
+
+        // 按主键写回修改过的对象
+        SqlSelect<radar_data> select;
+        select.select({"id", "location_id", "task_id"}).where("task_id", OperatorComparison::Equal, 2).limit(1000);
+        auto rows = select.exec() ? select.getResults() : std::vector<radar_data>{};
+        for (auto &row : rows)
+        {
+            row.location_id += 1;
+        }
+        SqlUpdate<radar_data> batch;
+        batch.columns({"location_id"}).update(rows).exec();
+        LogInfo("update radar_data: {} rows affected", batch.getNumAffected());
+    }
+    void TestDatabase::benchCopy()
+    {
+        // execBatch 与二进制 COPY 的写入速度对比，需连接本地 PostgreSQL 手动执行
+        for (int rows : {10000, 1000000})
+        {
+            std::vector<radar_data> lvObj(rows);
+            for (int i = 0; i < rows; i++)
+            {
+                lvObj[i].location_id = i;
+                lvObj[i].task_id = 1;
+                lvObj[i].points = R"({"points":[{"x":1,"y":2}]})";
+            }
+
+            auto begin = std::chrono::steady_clock::now();
+            SqlInsert<radar_data> insert;
+            bool insertOk = insert.insert(lvObj).exec();
+            double insertSec = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+            begin = std::chrono::steady_clock::now();
+            SqlCopy<radar_data> copy;
+            bool copyOk = copy.copy(lvObj).exec();
+            double copySec = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+            LogInfo("bench {} rows: execBatch {} {:.0f} rows/s, COPY {} {:.0f} rows/s",
+                    rows,
+                    insertOk ? "ok" : "failed",
+                    rows / insertSec,
+                    copyOk ? "ok" : "failed",
+                    rows / copySec);
+        }
+    }
+    void TestDatabase::benchPipeline()
+    {
+        // 逐条 QSqlQuery::exec 与 pipeline 的小语句吞吐对比，需连接本地 PostgreSQL 手动执行
+        const int count = 10000;
+        const QString sql = "INSERT INTO device_status (tag, details_json) VALUES ($1, $2)";
+        DBConnectionGuard guard;
+
+        auto begin = std::chrono::steady_clock::now();
+        QSqlQuery query(guard.get());
+        query.prepare("INSERT INTO device_status (tag, details_json) VALUES (?, ?)");
+        int sequentialOk = 0;
+        for (int i = 0; i < count; i++)
+        {
+            query.addBindValue(QString("bench_%1").arg(i));
+            query.addBindValue(R"({"state":"ok"})");
+            sequentialOk += query.exec() ? 1 : 0;
+        }
+        double sequentialSec = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+        begin = std::chrono::steady_clock::now();
+        PgPipeline pipeline(guard.get());
+        for (int i = 0; i < count; i++)
+        {
+            pipeline.add(sql, {QString("bench_%1").arg(i), R"({"state":"ok"})"});
+        }
+        int failed = pipeline.exec();
+        double pipelineSec = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+        LogInfo("bench {} statements: sequential {} ok {:.0f} stmt/s, pipeline {} failed {:.0f} stmt/s",
+                count,
+                sequentialOk,
+                count / sequentialSec,
+                failed,
+                count / pipelineSec);
+
+        // 删除压测行，否则重启后 DeviceStatusStore 会把它们当作设备的最新状态加载
+        QSqlQuery cleanup(guard.get());
+        if (!cleanup.exec(R"(DELETE FROM device_status WHERE tag LIKE 'bench\_%')"))
+        {
+            LogWarn("bench cleanup failed: {}", cleanup.lastError().text().toStdString());
         }
     }
 } // namespace _Controllers
\ No newline at end of file
@@ -8,6 +8,11 @@ namespace _Controllers
         void testCURD(const QVariant &);
         void insert();
         void select();
+        void selectAsync();
+        void scan();
+        void update();
+        void benchCopy();
+        void benchPipeline();
         TASK_LIST_BEGIN
         ASYNC_TASK_ADD(TIS_Info::DeviceManager::notifyDiskInfo, TestDatabase::testCURD);
         TASK_LIST_END
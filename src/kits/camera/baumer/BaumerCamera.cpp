@@ -1,5 +1,6 @@
 #include "BaumerCamera.h"
 #include "kits/object_pool/ObjectPool.h"
+#include "kits/required/log/LogRateLimit.h"
 #include <QDebug>
 #include <memory>
 #include <qlogging.h>
@@ -107,7 +108,12 @@ namespace _Kits
         }
         else
         {
-            qDebug() << "image data size error.";
+            LOG_EVERY_MS(spdlog::level::warn,
+                         1000,
+                         "image data size error: {} expected {}x{}",
+                         m_ip,
+                         width,
+                         height);
         }
     }
     bool BaumerCamera::start()
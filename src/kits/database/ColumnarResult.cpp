@@ -0,0 +1,355 @@
+#include "ColumnarResult.h"
+#include <QCborStreamWriter>
+#include <QDateTime>
+#include <QLocale>
+#include <QSqlField>
+#include <QSqlRecord>
+#include <QTimeZone>
+#include <cmath>
+
+namespace _Kits
+{
+    namespace
+    {
+        using Type = ColumnarColumn::Type;
+
+        Type columnType(const QSqlField &field)
+        {
+            switch (field.metaType().id())
+            {
+            case QMetaType::Bool:
+                return Type::Bool;
+            case QMetaType::Short:
+            case QMetaType::UShort:
+            case QMetaType::Int:
+            case QMetaType::UInt:
+            case QMetaType::Long:
+            case QMetaType::LongLong:
+                return Type::Int;
+            case QMetaType::ULong:
+            case QMetaType::ULongLong:
+                return Type::Text; // 可能超出 int64，以十进制文本原样输出
+            case QMetaType::Float:
+            case QMetaType::Double:
+                return Type::Real;
+            case QMetaType::QDate:
+                return Type::Date;
+            case QMetaType::QDateTime:
+                return Type::DateTime;
+            case QMetaType::QByteArray:
+                return Type::Bytes;
+            default:
+                return Type::Text;
+            }
+        }
+
+        const char *typeName(Type type)
+        {
+            switch (type)
+            {
+            case Type::Bool:
+                return "bool";
+            case Type::Int:
+                return "int";
+            case Type::Real:
+                return "real";
+            case Type::Date:
+                return "date";
+            case Type::DateTime:
+                return "datetime";
+            case Type::Bytes:
+                return "bytes";
+            default:
+                return "text";
+            }
+        }
+
+        QString isoTime(qint64 msecs)
+        {
+            return QDateTime::fromMSecsSinceEpoch(msecs, QTimeZone::UTC).toString(Qt::ISODateWithMs);
+        }
+
+        QString isoDate(qint64 julianDay)
+        {
+            return QDate::fromJulianDay(julianDay).toString(Qt::ISODate);
+        }
+
+        void appendJsonString(QByteArray &out, const QString &text)
+        {
+            static const char hex[] = "0123456789abcdef";
+            out.append('"');
+            for (char c : text.toUtf8())
+            {
+                switch (c)
+                {
+                case '"':
+                    out.append("\\\"");
+                    break;
+                case '\\':
+                    out.append("\\\\");
+                    break;
+                case '\n':
+                    out.append("\\n");
+                    break;
+                case '\r':
+                    out.append("\\r");
+                    break;
+                case '\t':
+                    out.append("\\t");
+                    break;
+                default:
+                    if (static_cast<unsigned char>(c) < 0x20)
+                    {
+                        out.append("\\u00").append(hex[(c >> 4) & 0xf]).append(hex[c & 0xf]);
+                    }
+                    else
+                    {
+                        out.append(c);
+                    }
+                    break;
+                }
+            }
+            out.append('"');
+        }
+
+        void appendJsonCell(QByteArray &out, const ColumnarColumn &column, std::size_t row)
+        {
+            if (column.nulls[row])
+            {
+                out.append("null");
+                return;
+            }
+            switch (column.type)
+            {
+            case Type::Bool:
+                out.append(column.ints[row] ? "true" : "false");
+                break;
+            case Type::Int:
+                out.append(QByteArray::number(column.ints[row]));
+                break;
+            case Type::Real:
+                if (std::isfinite(column.reals[row]))
+                    out.append(QByteArray::number(column.reals[row], 'g', QLocale::FloatingPointShortest));
+                else
+                    out.append("null");
+                break;
+            case Type::Date:
+                appendJsonString(out, isoDate(column.ints[row]));
+                break;
+            case Type::DateTime:
+                appendJsonString(out, isoTime(column.ints[row]));
+                break;
+            case Type::Bytes:
+                out.append('"').append(column.bytes[row].toBase64()).append('"');
+                break;
+            case Type::Text:
+                appendJsonString(out, column.texts[row]);
+                break;
+            }
+        }
+
+        void appendCborCell(QCborStreamWriter &writer, const ColumnarColumn &column, std::size_t row)
+        {
+            if (column.nulls[row])
+            {
+                writer.append(nullptr);
+                return;
+            }
+            switch (column.type)
+            {
+            case Type::Bool:
+                writer.append(column.ints[row] != 0);
+                break;
+            case Type::Int:
+                writer.append(column.ints[row]);
+                break;
+            case Type::Real:
+                writer.append(column.reals[row]);
+                break;
+            case Type::Date:
+                writer.append(QCborTag(1004)); // RFC 8943 full-date
+                writer.append(isoDate(column.ints[row]));
+                break;
+            case Type::DateTime:
+                writer.append(QCborKnownTags::DateTimeString);
+                writer.append(isoTime(column.ints[row]));
+                break;
+            case Type::Bytes:
+                writer.append(column.bytes[row]);
+                break;
+            case Type::Text:
+                writer.append(column.texts[row]);
+                break;
+            }
+        }
+    } // namespace
+
+    void ColumnarResult::read(QSqlQuery &query)
+    {
+        const auto record = query.record();
+        columns.assign(record.count(), {});
+        for (int i = 0; i < record.count(); ++i)
+        {
+            columns[i].name = record.fieldName(i);
+            columns[i].type = columnType(record.field(i));
+        }
+        // 只进结果集取不到总行数时 size() 为 -1
+        const auto expected = query.size() > 0 ? static_cast<std::size_t>(query.size()) : 0;
+        for (auto &column : columns)
+        {
+            column.nulls.reserve(expected);
+        }
+
+        rows = 0;
+        while (query.next())
+        {
+            for (std::size_t i = 0; i < columns.size(); ++i)
+            {
+                auto &column = columns[i];
+                const auto value = query.value(static_cast<int>(i));
+                const bool null = value.isNull();
+                column.nulls.push_back(null);
+                switch (column.type)
+                {
+                case Type::Bool:
+                    column.ints.push_back(null ? 0 : value.toBool());
+                    break;
+                case Type::Int:
+                    column.ints.push_back(null ? 0 : value.toLongLong());
+                    break;
+                case Type::Real:
+                    column.reals.push_back(null ? 0.0 : value.toDouble());
+                    break;
+                case Type::Date:
+                    column.ints.push_back(null ? 0 : value.toDate().toJulianDay());
+                    break;
+                case Type::DateTime:
+                    column.ints.push_back(null ? 0 : value.toDateTime().toMSecsSinceEpoch());
+                    break;
+                case Type::Bytes:
+                    column.bytes.push_back(null ? QByteArray() : value.toByteArray());
+                    break;
+                case Type::Text:
+                    column.texts.push_back(null ? QString() : value.toString());
+                    break;
+                }
+            }
+            ++rows;
+        }
+        ok = true;
+    }
+
+    QVariant ColumnarResult::value(std::size_t row, std::size_t column) const
+    {
+        if (column >= columns.size() || row >= rows)
+        {
+            return {};
+        }
+        const auto &col = columns[column];
+        if (col.nulls[row])
+        {
+            return {};
+        }
+        switch (col.type)
+        {
+        case Type::Bool:
+            return QVariant(col.ints[row] != 0);
+        case Type::Int:
+            return QVariant(col.ints[row]);
+        case Type::Real:
+            return QVariant(col.reals[row]);
+        case Type::Date:
+            return QVariant(QDate::fromJulianDay(col.ints[row]));
+        case Type::DateTime:
+            return QVariant(QDateTime::fromMSecsSinceEpoch(col.ints[row]));
+        case Type::Bytes:
+            return QVariant(col.bytes[row]);
+        case Type::Text:
+            return QVariant(col.texts[row]);
+        }
+        return {};
+    }
+
+    QByteArray ColumnarResult::toJson() const
+    {
+        QByteArray out;
+        if (rowsAffected >= 0)
+        {
+            out.append("{\"rows_affected\":").append(QByteArray::number(rowsAffected)).append('}');
+            return out;
+        }
+        // 按文本估算一次容量，避免大结果集反复扩容
+        out.reserve(static_cast<qsizetype>(64 + columns.size() * (32 + rows * 8)));
+        out.append("{\"columns\":[");
+        for (std::size_t i = 0; i < columns.size(); ++i)
+        {
+            if (i > 0)
+                out.append(',');
+            appendJsonString(out, columns[i].name);
+        }
+        out.append("],\"types\":[");
+        for (std::size_t i = 0; i < columns.size(); ++i)
+        {
+            out.append(i > 0 ? ",\"" : "\"").append(typeName(columns[i].type)).append('"');
+        }
+        out.append("],\"rows\":").append(QByteArray::number(static_cast<qulonglong>(rows))).append(",\"data\":[");
+        for (std::size_t i = 0; i < columns.size(); ++i)
+        {
+            out.append(i > 0 ? ",[" : "[");
+            for (std::size_t row = 0; row < rows; ++row)
+            {
+                if (row > 0)
+                    out.append(',');
+                appendJsonCell(out, columns[i], row);
+            }
+            out.append(']');
+        }
+        out.append("]}");
+        return out;
+    }
+
+    QByteArray ColumnarResult::toCbor() const
+    {
+        QByteArray out;
+        QCborStreamWriter writer(&out);
+        if (rowsAffected >= 0)
+        {
+            writer.startMap(1);
+            writer.append(QLatin1String("rows_affected"));
+            writer.append(static_cast<qint64>(rowsAffected));
+            writer.endMap();
+            return out;
+        }
+        writer.startMap(4);
+        writer.append(QLatin1String("columns"));
+        writer.startArray(columns.size());
+        for (const auto &column : columns)
+        {
+            writer.append(column.name);
+        }
+        writer.endArray();
+        writer.append(QLatin1String("types"));
+        writer.startArray(columns.size());
+        for (const auto &column : columns)
+        {
+            writer.append(QLatin1String(typeName(column.type)));
+        }
+        writer.endArray();
+        writer.append(QLatin1String("rows"));
+        writer.append(static_cast<quint64>(rows));
+        writer.append(QLatin1String("data"));
+        writer.startArray(columns.size());
+        for (const auto &column : columns)
+        {
+            writer.startArray(rows);
+            for (std::size_t row = 0; row < rows; ++row)
+            {
+                appendCborCell(writer, column, row);
+            }
+            writer.endArray();
+        }
+        writer.endArray();
+        writer.endMap();
+        return out;
+    }
+} // namespace _Kits
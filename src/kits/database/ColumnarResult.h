@@ -0,0 +1,58 @@
+#pragma once
+#include <QByteArray>
+#include <QSqlQuery>
+#include <QString>
+#include <QVariant>
+#include <cstdint>
+#include <vector>
+
+namespace _Kits
+{
+// 列式结果的一列，按字段类型只使用其中一个值数组
+struct ColumnarColumn
+{
+    enum class Type
+    {
+        Bool,
+        Int,
+        Real,
+        Text,
+        Date,
+        DateTime,
+        Bytes,
+    };
+    QString name;
+    Type type = Type::Text;
+    std::vector<qint64> ints;      // Bool、Int；Date 为儒略日数，DateTime 为自纪元起的毫秒数
+    std::vector<double> reals;     // Real
+    std::vector<QString> texts;    // Text
+    std::vector<QByteArray> bytes; // Bytes
+    std::vector<bool> nulls;
+};
+
+/**
+ * @brief 列式查询结果：列名与类型只存一次，每列一个按类型存放的数组。
+ *
+ * 相比逐行 QVariantMap，不再为每行分配映射和重复的键，可直接序列化为 JSON 或 CBOR：
+ * @code
+ * {"columns":["id","tag"],"types":["int","text"],"rows":2,"data":[[1,2],["a",null]]}
+ * @endcode
+ * 非查询语句只有 rows_affected。CBOR 结构相同，时间为带标签的 ISO 字符串，二进制为字节串；
+ * JSON 中时间为 UTC ISO 字符串，二进制为 base64。日期列为不带时区的 yyyy-MM-dd；
+ * 无符号 64 位整数列按十进制文本输出。
+ */
+struct ColumnarResult
+{
+    bool ok = false;
+    QString error;
+    int rowsAffected = -1; // 非查询语句的影响行数
+    std::size_t rows = 0;
+    std::vector<ColumnarColumn> columns;
+
+    /// @brief 读取已执行查询的全部行，列类型取自结果集字段类型
+    void read(QSqlQuery &query);
+    QVariant value(std::size_t row, std::size_t column) const;
+    QByteArray toJson() const;
+    QByteArray toCbor() const;
+};
+} // namespace _Kits
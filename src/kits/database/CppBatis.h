@@ -1,4 +1,5 @@
 #pragma once
+#include "ColumnarResult.h"
 #include "SqlInsert.h"
 #include "SqlSelect.h"
 #include "SqlTypes.h"
@@ -14,33 +15,32 @@ class CppBatis
     QVariantList execSql(const QString &sql)
     {
         DBConnectionGuard guard;
-        QSqlQuery query(guard.get());
-
-        if (!query.prepare(sql))
-        {
-            qDebug() << "SQL准备失败: " << query.lastError().text();
-            qDebug() << sql;
-            return {};
-        }
-
-        if (!query.exec())
+        QString error;
+        auto lease = execute(guard.get(), sql, error);
+        if (!lease)
         {
-            qDebug() << "SQL执行失败: " << query.lastError().text();
             return {};
         }
+        auto &query = *lease.query();
 
         QVariantList resultList;
 
         // 检查是否有结果集（即是否为SELECT查询）
         if (query.isSelect())
         {
+            // 字段名每个结果集只取一次
+            const QSqlRecord record = query.record();
+            QStringList names;
+            for (int i = 0; i < record.count(); ++i)
+            {
+                names << record.fieldName(i);
+            }
             while (query.next())
             {
                 QVariantMap recordMap;
-                QSqlRecord record = query.record();
-                for (int i = 0; i < record.count(); ++i)
+                for (int i = 0; i < names.size(); ++i)
                 {
-                    recordMap.insert(record.fieldName(i), record.value(i));
+                    recordMap.insert(names[i], query.value(i));
                 }
                 resultList.append(recordMap);
             }
@@ -55,5 +55,65 @@ class CppBatis
 
         return resultList;
     }
+
+    /// @brief 执行 SQL，结果按列存放，大结果集分配更少，可直接序列化为 JSON/CBOR
+    /// @param params 按 ? 占位符的位置绑定的参数
+    ColumnarResult execColumnar(const QString &sql, const QVariantList &params = {})
+    {
+        ColumnarResult result;
+        DBConnectionGuard guard;
+        auto lease = execute(guard.get(), sql, result.error, params);
+        if (!lease)
+        {
+            return result;
+        }
+        auto &query = *lease.query();
+        if (query.isSelect())
+        {
+            result.read(query);
+        }
+        else
+        {
+            result.ok = true;
+            result.rowsAffected = query.numRowsAffected();
+        }
+        return result;
+    }
+
+  private:
+    // 按规范化（合并空白）后的 SQL 复用连接上已 prepare 的语句并执行，失败返回空 Lease
+    static PreparedStatementCache::Lease execute(QSqlDatabase &db, const QString &sql, QString &error, const QVariantList &params = {})
+    {
+        auto lease = PreparedStatementCache::local().acquire(
+            db, QStringLiteral("SQL|") + sql.simplified(), [&sql] { return sql; }, error);
+        if (!lease)
+        {
+            qDebug() << "SQL准备失败: " << error;
+            qDebug() << sql;
+            return {};
+        }
+        auto &query = *lease.query();
+        for (int i = 0; i < params.size(); ++i)
+        {
+            query.bindValue(i, params[i]);
+        }
+
+        if (FlightRecorder::instance().isOpen())
+        {
+            flightEvent(FlightKind::database, sql.toStdString());
+        }
+        if (!query.exec())
+        {
+            error = query.lastError().text();
+            qDebug() << "SQL执行失败: " << error;
+            return {};
+        }
+        if (!query.isSelect())
+        {
+            // 写语句清除目标表的结果缓存
+            QueryResultCache::instance().invalidateForSql(sql);
+        }
+        return lease;
+    }
 };
 } // namespace _Kits
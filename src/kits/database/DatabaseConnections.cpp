@@ -1,79 +1,385 @@
 #include "DatabaseConnections.h"
-#include <QCoreApplication>
+#include "PreparedStatementCache.h"
+#include "kits/required/factory/StartupRegister.h"
+#include "kits/required/log/CRossLogger.h"
+#include "kits/required/log/LogRateLimit.h"
+#include <algorithm>
 #include <chrono>
 #include <qobject.h>
 #include <qtmetamacros.h>
 #include <thread>
+#include <unordered_set>
 
 namespace _Kits
 {
+    namespace
+    {
+        // 存活的连接池；线程退出回调与连接池析构互斥
+        std::mutex &livePoolsMutex()
+        {
+            static std::mutex mutex;
+            return mutex;
+        }
+
+        std::unordered_set<DatabaseConnections *> &livePools()
+        {
+            static std::unordered_set<DatabaseConnections *> pools;
+            return pools;
+        }
+
+        // 本线程取过连接的连接池，线程退出时在本线程关闭其空闲连接
+        struct ThreadPools
+        {
+            std::vector<DatabaseConnections *> pools;
+
+            ~ThreadPools()
+            {
+                std::lock_guard locker(livePoolsMutex());
+                for (auto *pool : pools)
+                {
+                    if (livePools().count(pool) > 0)
+                    {
+                        pool->releaseThread();
+                    }
+                }
+            }
+        };
+
+        ThreadPools &threadPools()
+        {
+            thread_local ThreadPools pools;
+            return pools;
+        }
+    } // namespace
 
     DatabaseConnections::DatabaseConnections(const QString &host,
                                              quint16 port,
                                              QString dbName,
                                              const QString &user,
                                              const QString &password,
-                                             int maxConnections,
+                                             const DatabasePoolOptions &options,
                                              QObject *parent)
         : QObject(parent), host_(host), port_(port), dbName_(dbName),
-          user_(user), password_(password), maxConnections_(maxConnections),
-          m_bInit(false)
+          user_(user), password_(password), m_bInit(false), m_options(options)
     {
+        std::lock_guard locker(livePoolsMutex());
+        livePools().insert(this);
     }
 
     DatabaseConnections::~DatabaseConnections()
     {
+        {
+            std::lock_guard locker(livePoolsMutex());
+            livePools().erase(this);
+        }
         m_bInit = false;
+        {
+            std::lock_guard locker(m_initMutex);
+            m_stopping = true;
+        }
+        m_initCv.notify_all();
         if (m_thInit.joinable())
             m_thInit.join();
     }
     bool DatabaseConnections::init()
     {
-        QObject::connect(this, &DatabaseConnections::already, [this]() {
-            if (checkAndCreateDatabase() && initializeDatabaseSchema() &&
-                initializeConnectionPool())
-            {
-                m_bInit = true;
-            }
-        });
+        // 由框架启动钩子调用，此时 QCoreApplication 已存在；建库建表可能较慢，放到初始化线程，
+        // 数据库暂不可用时按退避间隔重试，直到成功或连接池析构
         m_thInit = std::thread([this] {
-            while (true)
+            const auto begin = Clock::now();
+            auto retry = std::chrono::seconds(1);
+            while (!m_stopping)
             {
-                if (QCoreApplication::instance())
+                if (checkAndCreateDatabase() && initializeDatabaseSchema() && initializeConnectionPool())
                 {
+                    m_bInit = true;
+                    const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - begin).count();
+                    LogInfo("startup: database {} ready in {} ms, {} ms since process start",
+                            dbName_.toStdString(),
+                            elapsed,
+                            StartupRegister::mark("database_ready"));
                     emit already();
                     return;
                 }
-                std::this_thread::sleep_for(std::chrono::milliseconds(1000));
+                LogWarn("database {} bring-up failed, retry in {} s", dbName_.toStdString(), retry.count());
+                std::unique_lock locker(m_initMutex);
+                m_initCv.wait_for(locker, retry, [this] { return m_stopping.load(); });
+                retry = std::min(retry * 2, std::chrono::seconds(30));
             }
         });
         return true;
     }
 
+    bool DatabaseConnections::schemaStamped(QSqlDatabase &db, const QString &script, const QByteArray &checksum)
+    {
+        QSqlQuery query(db);
+        if (!query.exec("CREATE TABLE IF NOT EXISTS tis_schema_version ("
+                        "name VARCHAR(64) PRIMARY KEY, checksum VARCHAR(64) NOT NULL, "
+                        "applied_time TIMESTAMP DEFAULT CURRENT_TIMESTAMP)"))
+        {
+            return false;
+        }
+        query.prepare("SELECT checksum FROM tis_schema_version WHERE name = ?");
+        query.addBindValue(script);
+        return query.exec() && query.next() && query.value(0).toByteArray() == checksum;
+    }
+
+    void DatabaseConnections::stampSchema(QSqlDatabase &db, const QString &script, const QByteArray &checksum)
+    {
+        QSqlQuery query(db);
+        query.prepare("DELETE FROM tis_schema_version WHERE name = ?");
+        query.addBindValue(script);
+        query.exec();
+        query.prepare("INSERT INTO tis_schema_version (name, checksum) VALUES (?, ?)");
+        query.addBindValue(script);
+        query.addBindValue(QString::fromLatin1(checksum));
+        if (!query.exec())
+        {
+            LogWarn("schema stamp for {} failed: {}", script.toStdString(), query.lastError().text().toStdString());
+        }
+    }
+
     QSqlDatabase DatabaseConnections::getConnection()
     {
         if (!m_bInit)
         {
+            LOG_EVERY_MS(spdlog::level::warn, 5000, "database not ready, connection request rejected: {}", dbName_.toStdString());
             return {};
         }
-        std::lock_guard locker(mutex_);
-        if (!connectionPool_.empty())
+        trackThread();
+        const auto self = std::this_thread::get_id();
+        std::vector<QSqlDatabase> expired;
+        QSqlDatabase db;
+        bool create = false;
+        bool validateFirst = false;
+        bool timeout = false;
+        {
+            std::unique_lock locker(mutex_);
+            auto now = Clock::now();
+            collectExpired(self, now, expired);
+            auto it = m_idle.find(self);
+            if (it != m_idle.end() && !it->second.empty())
+            {
+                auto &idle = it->second.back();
+                validateFirst = now - idle.lastUsed >= std::chrono::milliseconds(m_options.validateIdleMs);
+                db = std::move(idle.db);
+                it->second.pop_back();
+                --m_idleCount;
+                ++m_stats.hits;
+            }
+            else if (m_total < m_options.maxConnections && m_waiters.empty())
+            {
+                ++m_total;
+                create = true;
+            }
+            else
+            {
+                // 先来先到：名额只转交给队首，超时后自行出队；其他线程的空闲连接不能在本线程关闭，
+                // 名额在其归还、空闲超时或线程退出时转交
+                ++m_stats.waits;
+                Waiter waiter;
+                m_waiters.push_back(&waiter);
+                create = waiter.cv.wait_for(locker,
+                                            std::chrono::milliseconds(m_options.waitTimeoutMs),
+                                            [&waiter] { return waiter.granted; });
+                if (!create)
+                {
+                    m_waiters.erase(std::find(m_waiters.begin(), m_waiters.end(), &waiter));
+                    ++m_stats.timeouts;
+                    timeout = true;
+                }
+            }
+        }
+        for (auto &item : expired)
+        {
+            closeConnection(std::move(item));
+        }
+
+        if (timeout)
+        {
+            LOG_EVERY_MS(spdlog::level::warn, 1000, "database pool exhausted, wait timeout: {}", dbName_.toStdString());
+            return {};
+        }
+        if (create)
         {
-            auto db = std::move(connectionPool_.front());
-            connectionPool_.pop_front();
-            return db;
+            return createCounted();
         }
-        else
+        if (validateFirst && !validate(db))
         {
-            return createConnection();
+            {
+                std::lock_guard locker(mutex_);
+                ++m_stats.pingFailures;
+                m_owners.erase(db.connectionName());
+            }
+            closeConnection(std::move(db));
+            return createCounted(); // 沿用原连接的名额
         }
+        return db;
     }
 
     void DatabaseConnections::restoreConnection(QSqlDatabase &&db)
     {
+        // 获取失败时返回的是无效连接，不占名额
+        if (!db.isValid())
+            return;
+        const auto name = db.connectionName();
+        {
+            std::unique_lock locker(mutex_);
+            auto owner = m_owners.find(name);
+            bool overflow = m_total > m_options.maxConnections;
+            // 等待者在其他线程，无法直接使用本连接：关闭后把名额转交给它
+            if (db.isOpen() && owner != m_owners.end() && !overflow && m_waiters.empty())
+            {
+                m_idle[owner->second].push_back({std::move(db), Clock::now()});
+                ++m_idleCount;
+                return;
+            }
+            if (owner != m_owners.end())
+            {
+                m_owners.erase(owner);
+            }
+            if (overflow)
+            {
+                ++m_stats.evictions;
+            }
+            releaseSlot();
+        }
+        closeConnection(std::move(db));
+    }
+
+    void DatabaseConnections::setOptions(const DatabasePoolOptions &options)
+    {
+        std::lock_guard locker(mutex_);
+        m_options = options;
+        // 扩容后立即唤醒等待者；缩容在连接归还时逐个关闭
+        while (!m_waiters.empty() && m_total < m_options.maxConnections)
+        {
+            ++m_total;
+            auto *waiter = m_waiters.front();
+            m_waiters.pop_front();
+            waiter->granted = true;
+            waiter->cv.notify_one();
+        }
+    }
+
+    DatabasePoolStats DatabaseConnections::stats()
+    {
+        std::lock_guard locker(mutex_);
+        auto stats = m_stats;
+        stats.total = m_total;
+        stats.idle = m_idleCount;
+        stats.waiting = static_cast<int>(m_waiters.size());
+        return stats;
+    }
+
+    void DatabaseConnections::closeConnection(QSqlDatabase &&db)
+    {
+        auto name = db.connectionName();
+        // 缓存的语句引用该连接，须先于连接释放
+        PreparedStatementCache::local().drop(name);
+        db.close();
+        db = QSqlDatabase();
+        QSqlDatabase::removeDatabase(name);
+    }
+
+    QSqlDatabase DatabaseConnections::createCounted()
+    {
+        auto db = createConnection();
         std::lock_guard locker(mutex_);
-        if (db.isOpen() && db.isValid())
-            connectionPool_.push_back(std::move(db));
+        if (!db.isValid() || !db.isOpen())
+        {
+            releaseSlot();
+            return {};
+        }
+        ++m_stats.creations;
+        m_owners[db.connectionName()] = std::this_thread::get_id();
+        return db;
+    }
+
+    bool DatabaseConnections::validate(QSqlDatabase &db)
+    {
+        if (!db.isOpen())
+        {
+            return false;
+        }
+        QSqlQuery query(db);
+        return query.exec("SELECT 1");
+    }
+
+    void DatabaseConnections::releaseSlot()
+    {
+        if (m_waiters.empty())
+        {
+            --m_total;
+            return;
+        }
+        auto *waiter = m_waiters.front();
+        m_waiters.pop_front();
+        waiter->granted = true;
+        waiter->cv.notify_one();
+    }
+
+    void DatabaseConnections::collectExpired(std::thread::id owner,
+                                             Clock::time_point now,
+                                             std::vector<QSqlDatabase> &expired)
+    {
+        auto it = m_idle.find(owner);
+        if (it == m_idle.end())
+        {
+            return;
+        }
+        auto &list = it->second;
+        const auto limit = std::chrono::milliseconds(m_options.idleTimeoutMs);
+        // 列表按归还时间递增，过期连接集中在头部
+        auto end = std::find_if(list.begin(), list.end(), [&](const IdleConnection &idle) {
+            return now - idle.lastUsed < limit;
+        });
+        for (auto item = list.begin(); item != end; ++item)
+        {
+            m_owners.erase(item->db.connectionName());
+            expired.push_back(std::move(item->db));
+            --m_idleCount;
+            ++m_stats.evictions;
+            releaseSlot();
+        }
+        list.erase(list.begin(), end);
+    }
+
+    void DatabaseConnections::trackThread()
+    {
+        // 先构造本线程的语句缓存：thread_local 按构造的逆序析构，退出回调关闭连接时缓存仍然有效
+        PreparedStatementCache::local();
+        auto &pools = threadPools().pools;
+        if (std::find(pools.begin(), pools.end(), this) == pools.end())
+        {
+            pools.push_back(this);
+        }
+    }
+
+    void DatabaseConnections::releaseThread()
+    {
+        std::vector<QSqlDatabase> released;
+        {
+            std::lock_guard locker(mutex_);
+            auto it = m_idle.find(std::this_thread::get_id());
+            if (it == m_idle.end())
+            {
+                return;
+            }
+            for (auto &idle : it->second)
+            {
+                m_owners.erase(idle.db.connectionName());
+                released.push_back(std::move(idle.db));
+                --m_idleCount;
+                ++m_stats.evictions;
+                releaseSlot();
+            }
+            m_idle.erase(it);
+        }
+        for (auto &db : released)
+        {
+            closeConnection(std::move(db));
+        }
     }
 
-} // namespace _Kits
\ No newline at end of file
+} // namespace _Kits
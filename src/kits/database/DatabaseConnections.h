@@ -2,14 +2,52 @@
 #include <QSqlDatabase>
 #include <QSqlError>
 #include <QSqlQuery>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
 #include <deque>
 #include <mutex>
 #include <qobject.h>
 #include <qtmetamacros.h>
 #include <thread>
+#include <unordered_map>
+#include <vector>
 namespace _Kits
 {
+// 连接池参数，可由配置热更新
+struct DatabasePoolOptions
+{
+    int maxConnections = 16;  // 连接总数上限（含使用中）
+    int waitTimeoutMs = 5000; // 达到上限时的最长等待
+    int idleTimeoutMs = 60000; // 空闲超过该时长的连接被关闭
+    int validateIdleMs = 5000; // 空闲超过该时长的连接取出时先 ping
+};
+
+// 连接池计数，stats() 返回快照
+struct DatabasePoolStats
+{
+    uint64_t hits = 0;        // 直接复用本线程空闲连接
+    uint64_t waits = 0;       // 达到上限进入等待队列
+    uint64_t creations = 0;   // 新建连接
+    uint64_t timeouts = 0;    // 等待超时
+    uint64_t evictions = 0;   // 空闲超时或缩容关闭
+    uint64_t pingFailures = 0; // 取出时校验失败
+    int total = 0;            // 当前连接数（含使用中与创建中）
+    int idle = 0;
+    int waiting = 0;
+};
 
+/**
+ * @brief 有界、线程亲和的数据库连接池。
+ *
+ * QSqlDatabase 只能在创建它的线程中使用，因此空闲连接按所属线程分组，
+ * 每个线程只会取回自己创建的连接，没有可用连接时在本线程新建。
+ * 连接总数达到上限后请求按先来先到排队等待；其他线程归还连接时，
+ * 由归还线程关闭该连接并把名额转交给队首等待者。
+ * 连接只在所属线程上关闭：空闲超时的连接由所属线程下次取连接时关闭，
+ * 线程退出时其全部空闲连接随之关闭并归还名额。
+ */
 class DatabaseConnections : public QObject
 {
     Q_OBJECT
@@ -19,14 +57,19 @@ class DatabaseConnections : public QObject
                                  QString dbName,
                                  const QString &user,
                                  const QString &password,
-                                 int maxConnections = 20,
+                                 const DatabasePoolOptions &options = {},
                                  QObject *parent = nullptr);
     virtual ~DatabaseConnections();
     bool init();
     QSqlDatabase getConnection();
     void restoreConnection(QSqlDatabase &&db);
     bool isReady(){return m_bInit;};
+    void setOptions(const DatabasePoolOptions &options);
+    DatabasePoolStats stats();
+    /// @brief 关闭当前线程的全部空闲连接并归还名额，线程退出时自动调用
+    void releaseThread();
   signals:
+    /// @brief 建库、建表与连接校验完成，在初始化线程发出
     void already();
 
   protected:
@@ -34,19 +77,52 @@ class DatabaseConnections : public QObject
     virtual bool initializeDatabaseSchema() = 0;
     virtual bool initializeConnectionPool() = 0;
     virtual QSqlDatabase createConnection() = 0;
-    std::vector<QString> m_poolNames;
-    std::deque<QSqlDatabase> connectionPool_;
+    /// @brief 关闭连接并从 Qt 连接表移除
+    static void closeConnection(QSqlDatabase &&db);
+    /// @brief 建表脚本与库中记录的版本戳（校验和）一致时返回 true，可跳过执行脚本
+    static bool schemaStamped(QSqlDatabase &db, const QString &script, const QByteArray &checksum);
+    /// @brief 脚本全部执行成功后记录版本戳
+    static void stampSchema(QSqlDatabase &db, const QString &script, const QByteArray &checksum);
+
     std::vector<QString> dbNameList_;
-    std::mutex mutex_;
-    int maxConnections_;
-    int count_ = 0;
-    int idleTimeout_;
+    std::atomic<int> count_{0};
     QString host_;
     quint16 port_;
     QString dbName_;
     QString user_;
     QString password_;
-    bool m_bInit;
+    std::atomic<bool> m_bInit;
     std::thread m_thInit;
+
+  private:
+    using Clock = std::chrono::steady_clock;
+    struct IdleConnection
+    {
+        QSqlDatabase db;
+        Clock::time_point lastUsed;
+    };
+    struct Waiter
+    {
+        std::condition_variable cv;
+        bool granted = false;
+    };
+
+    QSqlDatabase createCounted();
+    bool validate(QSqlDatabase &db);
+    void releaseSlot(); // 调用方持有 mutex_
+    void collectExpired(std::thread::id owner, Clock::time_point now, std::vector<QSqlDatabase> &expired);
+    void trackThread();
+
+    std::mutex mutex_;
+    std::mutex m_initMutex;
+    std::condition_variable m_initCv;
+    std::atomic<bool> m_stopping{false};
+    DatabasePoolOptions m_options;
+    std::unordered_map<std::thread::id, std::vector<IdleConnection>> m_idle; // 按所属线程分组，后进先出
+    std::unordered_map<QString, std::thread::id> m_owners;                 // 连接名 -> 创建线程
+    std::deque<Waiter *> m_waiters;
+    int m_total = 0;
+    int m_idleCount = 0;
+    DatabasePoolStats m_stats;
 };
-} // namespace _Kits
\ No newline at end of file
+} // namespace _Kits
@@ -0,0 +1,277 @@
+#include "DatabaseExecutor.h"
+#include "PgsqlConnections.h"
+#include "kits/required/config/ConfigService.h"
+#include "kits/required/factory/StartupRegister.h"
+#include "kits/required/log/CRossLogger.h"
+#include <algorithm>
+#include <libpq-fe.h>
+
+namespace _Kits
+{
+    namespace
+    {
+        // 取消后任务仍未返回（事务内还有后续语句）时重发取消的间隔
+        constexpr auto kCancelRetry = std::chrono::milliseconds(200);
+    } // namespace
+
+    DatabaseExecutor::DatabaseExecutor()
+    {
+        int threads = std::max(ConfigService::instance().snapshot()->database.executorThreads, 1);
+        m_inFlight = std::vector<InFlight>(static_cast<std::size_t>(threads));
+        m_watchdog = std::thread([this]() { watchdogLoop(); });
+        m_workers.reserve(threads);
+        for (int i = 0; i < threads; ++i)
+        {
+            m_workers.emplace_back([this, i]() { workerLoop(static_cast<std::size_t>(i)); });
+        }
+    }
+
+    DatabaseExecutor::~DatabaseExecutor()
+    {
+        stop();
+    }
+
+    void DatabaseExecutor::stop()
+    {
+        std::deque<Task> dropped;
+        {
+            std::lock_guard locker(m_mutex);
+            if (!m_running)
+            {
+                return;
+            }
+            m_running = false;
+            dropped.swap(m_tasks);
+        }
+        m_cv.notify_all();
+        for (auto &worker : m_workers)
+        {
+            if (worker.joinable())
+            {
+                worker.join();
+            }
+        }
+        // 执行线程可能在等待看门狗结束取消，须在其退出后再停止看门狗
+        {
+            std::lock_guard locker(m_inFlightMutex);
+            m_watchdogStop = true;
+        }
+        m_inFlightCv.notify_all();
+        if (m_watchdog.joinable())
+        {
+            m_watchdog.join();
+        }
+        for (auto &task : dropped)
+        {
+            task.fail(std::make_exception_ptr(DatabaseTaskError("database executor stopped")));
+        }
+    }
+
+    std::size_t DatabaseExecutor::pending()
+    {
+        std::lock_guard locker(m_mutex);
+        return m_tasks.size();
+    }
+
+    void DatabaseExecutor::warmUp()
+    {
+        {
+            std::lock_guard locker(m_mutex);
+            if (!m_running)
+            {
+                return;
+            }
+            m_warming = static_cast<int>(m_workers.size());
+            ++m_warmGeneration;
+        }
+        m_cv.notify_all();
+    }
+
+    void DatabaseExecutor::enqueue(Task &&task)
+    {
+        {
+            std::lock_guard locker(m_mutex);
+            if (m_running)
+            {
+                m_tasks.push_back(std::move(task));
+                m_cv.notify_one();
+                return;
+            }
+        }
+        task.fail(std::make_exception_ptr(DatabaseTaskError("database executor stopped")));
+    }
+
+    void DatabaseExecutor::workerLoop(std::size_t index)
+    {
+        QSqlDatabase db;
+        int statementTimeoutMs = 0; // 当前连接上生效的 statement_timeout
+        auto lastUsed = Clock::now();
+        uint64_t warmed = 0;
+        // 连接在本线程创建并长期持有，失效后归还并重新获取
+        auto connect = [&db, &statementTimeoutMs]() {
+            if (db.isValid() && db.isOpen())
+            {
+                return true;
+            }
+            if (db.isValid())
+            {
+                DatabaseManager::restoreConnection(std::move(db));
+            }
+            db = DatabaseManager::getConnection();
+            statementTimeoutMs = 0;
+            return db.isValid();
+        };
+        while (true)
+        {
+            Task task;
+            bool warm = false;
+            {
+                std::unique_lock locker(m_mutex);
+                m_cv.wait(locker, [this, &warmed]() { return !m_running || !m_tasks.empty() || warmed != m_warmGeneration; });
+                if (!m_running)
+                {
+                    break;
+                }
+                if (warmed != m_warmGeneration)
+                {
+                    warmed = m_warmGeneration;
+                    warm = true;
+                }
+                else
+                {
+                    task = std::move(m_tasks.front());
+                    m_tasks.pop_front();
+                }
+            }
+
+            if (warm)
+            {
+                connect();
+                lastUsed = Clock::now();
+                if (m_warming.fetch_sub(1) == 1)
+                {
+                    LogInfo("startup: database executor warmed ({} connections) at {} ms", m_workers.size(),
+                            StartupRegister::mark("database_warm"));
+                }
+                continue;
+            }
+
+            if (task.canceled())
+            {
+                task.fail(std::make_exception_ptr(DatabaseTaskError("database task canceled")));
+                continue;
+            }
+            if (Clock::now() >= task.deadline)
+            {
+                LogWarn("database task expired in queue after {} ms", task.timeoutMs);
+                task.fail(std::make_exception_ptr(DatabaseTaskError("database task timeout")));
+                continue;
+            }
+            // 空闲较久时先 ping，失效后重新获取
+            auto validateIdle = std::chrono::milliseconds(ConfigService::instance().snapshot()->database.validateIdleMs);
+            if (db.isOpen() && Clock::now() - lastUsed >= validateIdle && !QSqlQuery(db).exec("SELECT 1"))
+            {
+                db.close();
+            }
+            if (!connect())
+            {
+                task.fail(std::make_exception_ptr(DatabaseTaskError("database not ready")));
+                continue;
+            }
+            if (db.driverName() == "QPSQL" && task.timeoutMs != statementTimeoutMs)
+            {
+                QSqlQuery query(db);
+                if (query.exec(QString("SET statement_timeout = %1").arg(task.timeoutMs)))
+                {
+                    statementTimeoutMs = task.timeoutMs;
+                }
+            }
+
+            // 有时限的 PostgreSQL 任务登记给看门狗，到时取消执行中的语句
+            PGcancel *cancel = nullptr;
+            if (task.timeoutMs > 0)
+            {
+                if (auto *conn = PgsqlConnections::nativeHandle(db))
+                {
+                    cancel = PQgetCancel(conn);
+                }
+            }
+            auto &slot = m_inFlight[index];
+            if (cancel != nullptr)
+            {
+                {
+                    std::lock_guard locker(m_inFlightMutex);
+                    slot.cancel = cancel;
+                    slot.deadline = task.deadline;
+                    slot.timedOut = task.timedOut.get();
+                }
+                m_inFlightCv.notify_all();
+            }
+
+            DatabaseManager::bindThreadConnection(&db);
+            task.run();
+            DatabaseManager::bindThreadConnection(nullptr);
+            lastUsed = Clock::now();
+
+            if (cancel != nullptr)
+            {
+                {
+                    std::unique_lock locker(m_inFlightMutex);
+                    m_inFlightCv.wait(locker, [&slot]() { return !slot.cancelling; });
+                    slot = InFlight();
+                }
+                PQfreeCancel(cancel);
+            }
+        }
+        if (db.isValid())
+        {
+            DatabaseManager::restoreConnection(std::move(db));
+        }
+    }
+
+    void DatabaseExecutor::watchdogLoop()
+    {
+        std::unique_lock locker(m_inFlightMutex);
+        while (!m_watchdogStop)
+        {
+            auto next = Clock::time_point::max();
+            for (auto &slot : m_inFlight)
+            {
+                if (slot.cancel == nullptr)
+                {
+                    continue;
+                }
+                if (slot.deadline <= Clock::now())
+                {
+                    // PQcancel 需要新建一次网络往返，不持锁执行；cancelling 期间执行线程不会释放 cancel
+                    slot.cancelling = true;
+                    const bool first = !slot.timedOut->exchange(true);
+                    auto *cancel = slot.cancel;
+                    locker.unlock();
+                    if (first)
+                    {
+                        LogWarn("database task timeout, canceling in-flight statement");
+                    }
+                    char error[256] = {};
+                    if (PQcancel(cancel, error, sizeof(error)) == 0)
+                    {
+                        LogWarn("database cancel request failed: {}", std::string(error));
+                    }
+                    locker.lock();
+                    slot.cancelling = false;
+                    slot.deadline = Clock::now() + kCancelRetry;
+                    m_inFlightCv.notify_all();
+                }
+                next = std::min(next, slot.deadline);
+            }
+            if (next == Clock::time_point::max())
+            {
+                m_inFlightCv.wait(locker);
+            }
+            else
+            {
+                m_inFlightCv.wait_until(locker, next);
+            }
+        }
+    }
+} // namespace _Kits
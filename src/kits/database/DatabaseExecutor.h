@@ -0,0 +1,193 @@
+#pragma once
+#include "CppBatis.h"
+#include "SqlInsert.h"
+#include "SqlSelect.h"
+#include <QFuture>
+#include <QPromise>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+typedef struct pg_cancel PGcancel;
+
+namespace _Kits
+{
+// 提交到 DatabaseExecutor 的任务未能执行（排队超时、数据库未就绪、执行器已停止）
+class DatabaseTaskError : public std::runtime_error
+{
+  public:
+    using std::runtime_error::runtime_error;
+};
+
+/**
+ * @brief 数据库专用执行器：固定数量的线程，每个线程持有一条连接，按提交顺序执行任务。
+ *
+ * 任务在执行线程上构造/执行查询，调用方线程不会阻塞在数据库往返上；
+ * 结果以 QFuture 返回，可用 then()/onFailed()/onCanceled() 串联后续处理。
+ *
+ * - 超时：timeoutMs > 0 时从提交时刻计时，排队超过时限的任务不再执行，future 以 DatabaseTaskError 失败。
+ *   PostgreSQL 连接上已开始执行的任务到时后由看门狗线程 PQcancel 当前语句，任务仍在执行时周期性重发，
+ *   future 同样以超时失败；statement_timeout 作为服务端兜底。其他驱动无法中途取消，任务执行完为止。
+ * - 取消：future.cancel() 后，尚未开始的任务直接丢弃。
+ *
+ * @code
+ * SqlSelect<radar_data> select;
+ * select.where("location_id", OperatorComparison::Equal, id);
+ * dbExecutor().select(std::move(select), 3000).then([](const std::vector<radar_data> &rows) {
+ *     ...
+ * });
+ * @endcode
+ */
+class DatabaseExecutor
+{
+  public:
+    static DatabaseExecutor &instance()
+    {
+        static DatabaseExecutor executor;
+        return executor;
+    }
+    ~DatabaseExecutor();
+
+    /// @brief 提交任意任务，在执行线程上运行，返回值作为 future 结果
+    template <typename F>
+    auto submit(F &&task, int timeoutMs = 0) -> QFuture<std::invoke_result_t<std::decay_t<F>>>
+    {
+        using R = std::invoke_result_t<std::decay_t<F>>;
+        auto promise = std::make_shared<QPromise<R>>();
+        auto future = promise->future();
+        promise->start();
+
+        Task item;
+        item.timedOut = std::make_shared<std::atomic<bool>>(false);
+        item.timeoutMs = timeoutMs;
+        item.deadline = timeoutMs > 0 ? Clock::now() + std::chrono::milliseconds(timeoutMs) : Clock::time_point::max();
+        item.canceled = [promise]() { return promise->isCanceled(); };
+        item.fail = [promise](std::exception_ptr error) {
+            promise->setException(error);
+            promise->finish();
+        };
+        item.run = [promise, timedOut = item.timedOut, task = std::forward<F>(task)]() mutable {
+            // 语句被超时取消后，任务得到的是不完整的结果或取消错误，统一按超时上报
+            auto timeout = [&timedOut]() {
+                if (timedOut->load())
+                {
+                    throw DatabaseTaskError("database task timeout");
+                }
+            };
+            try
+            {
+                if constexpr (std::is_void_v<R>)
+                {
+                    task();
+                    timeout();
+                }
+                else
+                {
+                    auto result = task();
+                    timeout();
+                    promise->addResult(std::move(result));
+                }
+            }
+            catch (...)
+            {
+                promise->setException(timedOut->load() ? std::make_exception_ptr(DatabaseTaskError("database task timeout"))
+                                                       : std::current_exception());
+            }
+            promise->finish();
+        };
+        enqueue(std::move(item));
+        return future;
+    }
+
+    template <typename T>
+    QFuture<std::vector<T>> select(SqlSelect<T> &&query, int timeoutMs = 0)
+    {
+        auto holder = std::make_shared<SqlSelect<T>>(std::move(query));
+        return submit(
+            [holder]() {
+                // 结果在执行线程读取，查询对象随任务在执行线程析构
+                auto results = holder->exec() ? holder->getResults() : std::vector<T>{};
+                return results;
+            },
+            timeoutMs);
+    }
+
+    template <typename T>
+    QFuture<bool> insert(SqlInsert<T> &&query, int timeoutMs = 0)
+    {
+        auto holder = std::make_shared<SqlInsert<T>>(std::move(query));
+        return submit([holder]() { return holder->exec(); }, timeoutMs);
+    }
+
+    QFuture<QVariantList> execSql(const QString &sql, int timeoutMs = 0)
+    {
+        return submit([sql]() { return CppBatis().execSql(sql); }, timeoutMs);
+    }
+
+    QFuture<ColumnarResult> execColumnar(const QString &sql, int timeoutMs = 0)
+    {
+        return submit([sql]() { return CppBatis().execColumnar(sql); }, timeoutMs);
+    }
+
+    std::size_t pending();
+    /// @brief 数据库就绪后由各执行线程并行建立连接，首批任务不再承担建连耗时
+    void warmUp();
+    void stop();
+
+  protected:
+    DatabaseExecutor();
+    DatabaseExecutor(const DatabaseExecutor &) = delete;
+    DatabaseExecutor &operator=(const DatabaseExecutor &) = delete;
+
+  private:
+    using Clock = std::chrono::steady_clock;
+    struct Task
+    {
+        std::function<void()> run;
+        std::function<bool()> canceled;
+        std::function<void(std::exception_ptr)> fail;
+        Clock::time_point deadline;
+        int timeoutMs = 0;
+        std::shared_ptr<std::atomic<bool>> timedOut; // 执行中被看门狗取消
+    };
+    // 执行线程上正在运行、可取消的任务，每个执行线程一项
+    struct InFlight
+    {
+        PGcancel *cancel = nullptr; // 为空表示当前没有可取消的任务
+        Clock::time_point deadline = Clock::time_point::max();
+        std::atomic<bool> *timedOut = nullptr;
+        bool cancelling = false; // 看门狗正在使用 cancel，执行线程须等待后才能释放
+    };
+
+    void enqueue(Task &&task);
+    void workerLoop(std::size_t index);
+    void watchdogLoop();
+
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    std::deque<Task> m_tasks;
+    std::vector<std::thread> m_workers;
+    bool m_running = true;
+    uint64_t m_warmGeneration = 0; // 每次 warmUp 递增，执行线程据此判断是否需要预热
+    std::atomic<int> m_warming{0};  // 尚未完成预热的执行线程数
+
+    std::mutex m_inFlightMutex;
+    std::condition_variable m_inFlightCv;
+    std::vector<InFlight> m_inFlight; // 按执行线程下标，构造后大小不变
+    bool m_watchdogStop = false;
+    std::thread m_watchdog;
+};
+
+inline DatabaseExecutor &dbExecutor()
+{
+    return DatabaseExecutor::instance();
+}
+} // namespace _Kits
@@ -1,50 +1,63 @@
 #include "DatabaseManager.h"
+#include "DatabaseExecutor.h"
 #include "MysqlConnections.h"
 #include "PgsqlConnections.h"
-#include <filesystem>
+#include "kits/required/config/ConfigService.h"
+#include "kits/required/factory/StartupRegister.h"
+#include <algorithm>
 #include <memory>
 #include <utility>
-#include <yaml-cpp/yaml.h>
 namespace _Kits
 {
+static DatabasePoolOptions poolOptionsFrom(const DatabaseConfig &config)
+{
+    DatabasePoolOptions options;
+    options.maxConnections = std::max(config.maxConnections, 1);
+    options.waitTimeoutMs = config.waitTimeoutMs;
+    options.idleTimeoutMs = config.idleTimeoutMs;
+    options.validateIdleMs = config.validateIdleMs;
+    return options;
+}
+
 bool DatabaseManager::start()
 {
-    std::string filePath =
-        std::filesystem::current_path().string() + "/config/config.yaml";
-    auto config = YAML::LoadFile(filePath);
+    if (m_dbPools)
+    {
+        return true;
+    }
+    auto config = ConfigService::instance().snapshot();
 
-    if (!config["database"])
+    if (!config->root["database"])
     {
         qDebug() << "Invalid or missing database configuration.";
         return false;
     }
-    const auto &item = config["database"];
+    const auto &item = config->database;
 
-    if (!item["rdbms"] || !item["host"] || !item["port"] || !item["db_name"] ||
-        !item["user"])
+    if (!item.valid)
     {
         qDebug() << "Incomplete database configuration."
-                 << item["rdbms"].as<std::string>();
+                 << QString::fromStdString(item.rdbms);
         return false;
     }
 
-    QString rdbms = QString::fromStdString(item["rdbms"].as<std::string>());
-    QString host = QString::fromStdString(item["host"].as<std::string>());
-    quint16 port = static_cast<quint16>(item["port"].as<int>());
-    QString dbName = QString::fromStdString(item["db_name"].as<std::string>());
-    QString user = QString::fromStdString(item["user"].as<std::string>());
+    QString rdbms = QString::fromStdString(item.rdbms);
+    QString host = QString::fromStdString(item.host);
+    quint16 port = item.port;
+    QString dbName = QString::fromStdString(item.dbName);
+    QString user = QString::fromStdString(item.user);
     QString password;
     if (rdbms == "postgresql")
     {
         password = QString("~postgres@");
         m_dbPools = std::make_unique<PgsqlConnections>(
-            host, port, dbName, user, password);
+            host, port, dbName, user, password, poolOptionsFrom(item));
     }
     else if (rdbms == "mysql")
     {
         password = QString("123456");
         m_dbPools = std::make_unique<MysqlConnections>(
-            host, port, dbName, user, password);
+            host, port, dbName, user, password, poolOptionsFrom(item));
     }
     else
     {
@@ -57,15 +70,31 @@ bool DatabaseManager::start()
         qDebug() << "error: database can not load; " << rdbms << "," << dbName;
         return false;
     }
+    // 就绪后各执行线程同时建立连接，首个业务查询不再承担建连耗时
+    QObject::connect(m_dbPools.get(), &DatabaseConnections::already, []() { DatabaseExecutor::instance().warmUp(); });
     m_dbPools->init();
+    // 连接池上限与超时随配置热更新
+    ConfigService::instance().subscribe([](const ConfigSnapshot &snapshot) {
+        m_dbPools->setOptions(poolOptionsFrom(snapshot.database));
+    });
     return true;
 }
 QSqlDatabase DatabaseManager::getConnection()
 {
-    return m_dbPools->getConnection();
+    return m_dbPools ? m_dbPools->getConnection() : QSqlDatabase();
 }
 void DatabaseManager::restoreConnection(QSqlDatabase &&db)
 {
-    return m_dbPools->restoreConnection(std::move(db));
+    // 未创建连接池时不会有有效连接
+    if (m_dbPools)
+    {
+        m_dbPools->restoreConnection(std::move(db));
+    }
+}
+DatabasePoolStats DatabaseManager::poolStats()
+{
+    return m_dbPools ? m_dbPools->stats() : DatabasePoolStats{};
 }
 } // namespace _Kits
+
+DECLARE_STARTUP("database", []() { _Kits::DatabaseManager::start(); })
@@ -13,10 +13,21 @@ class DatabaseManager
 {
   public:
     ~DatabaseManager() = default;
+    /// @brief 创建连接池并在后台建库、建表、预热连接；由框架启动钩子调用
     static bool start();
     static QSqlDatabase getConnection();
     static void restoreConnection(QSqlDatabase &&db);
-    static bool isReady(){return m_dbPools->isReady();};
+    static DatabasePoolStats poolStats();
+    /// @brief 将连接绑定到当前线程，绑定期间 DBConnectionGuard 直接使用该连接（nullptr 解除绑定）
+    static void bindThreadConnection(QSqlDatabase *db)
+    {
+        m_boundConnection = db;
+    }
+    static QSqlDatabase *boundConnection()
+    {
+        return m_boundConnection;
+    }
+    static bool isReady(){return m_dbPools && m_dbPools->isReady();};
 
   protected:
     DatabaseManager() = default;
@@ -25,23 +36,32 @@ class DatabaseManager
     DatabaseManager(DatabaseManager &&) = delete;
 
   private:
-    inline static std::unique_ptr<DatabaseConnections> m_dbPools;
-    inline static bool m_bSelfCreator = [] {
-        DatabaseManager::start();
-        return true;
-    }();
+    inline static std::unique_ptr<DatabaseConnections> m_dbPools; // 框架启动时由启动钩子创建
+    inline static thread_local QSqlDatabase *m_boundConnection = nullptr;
 };
 
 class DBConnectionGuard
 {
   public:
-    DBConnectionGuard() : m_db(DatabaseManager::getConnection())
+    DBConnectionGuard()
     {
+        if (auto *bound = DatabaseManager::boundConnection())
+        {
+            m_db = *bound;
+            m_bound = true;
+        }
+        else
+        {
+            m_db = DatabaseManager::getConnection();
+        }
     }
 
     ~DBConnectionGuard()
     {
-        DatabaseManager::restoreConnection(std::move(m_db));
+        if (!m_bound)
+        {
+            DatabaseManager::restoreConnection(std::move(m_db));
+        }
     }
 
     // 获取连接
@@ -52,5 +72,6 @@ class DBConnectionGuard
 
   private:
     QSqlDatabase m_db;
+    bool m_bound = false; // 线程绑定的连接由绑定方负责归还
 };
 } // namespace _Kits
@@ -0,0 +1,150 @@
+#include "DeviceStatusStore.h"
+#include "DatabaseManager.h"
+#include "WriteBehind.h"
+#include "kits/orm/OrmMapperImpl.h"
+#include "kits/required/config/ConfigService.h"
+#include "kits/required/log/CRossLogger.h"
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QSqlRecord>
+
+namespace _Kits
+{
+    DeviceStatusStore &DeviceStatusStore::instance()
+    {
+        static DeviceStatusStore store;
+        return store;
+    }
+
+    bool DeviceStatusStore::report(const QString &tag, const QString &detailsJson)
+    {
+        load();
+        const auto now = QDateTime::currentDateTime();
+        const int keyframeMs = ConfigService::instance().snapshot()->database.deviceStatusKeyframeMs;
+        device_status row;
+        {
+            std::lock_guard locker(m_mutex);
+            ++m_stats.reported;
+            auto it = m_states.find(tag);
+            const bool changed = it == m_states.end() || it->second.status.details_json != detailsJson;
+            if (changed)
+            {
+                auto &entry = m_states[tag];
+                entry.status.tag = tag;
+                entry.status.details_json = detailsJson;
+                entry.status.created_time = now;
+                entry.status.updated_time = now;
+                entry.persistedAt = now;
+                ++m_stats.changed;
+            }
+            else
+            {
+                auto &entry = it->second;
+                entry.status.updated_time = now;
+                if (keyframeMs <= 0 || entry.persistedAt.msecsTo(now) < keyframeMs)
+                {
+                    ++m_stats.unchanged;
+                    return false;
+                }
+                entry.persistedAt = now;
+                ++m_stats.keyframes;
+            }
+            row.tag = tag;
+            row.details_json = detailsJson;
+            row.created_time = now;
+            row.updated_time = now;
+        }
+        writeBehind().push(std::move(row));
+        return true;
+    }
+
+    std::optional<device_status> DeviceStatusStore::current(const QString &tag)
+    {
+        load();
+        std::lock_guard locker(m_mutex);
+        auto it = m_states.find(tag);
+        if (it == m_states.end())
+        {
+            return std::nullopt;
+        }
+        return it->second.status;
+    }
+
+    std::vector<device_status> DeviceStatusStore::currentAll()
+    {
+        load();
+        std::lock_guard locker(m_mutex);
+        std::vector<device_status> states;
+        states.reserve(m_states.size());
+        for (const auto &[tag, entry] : m_states)
+        {
+            states.push_back(entry.status);
+        }
+        return states;
+    }
+
+    DeviceStatusStore::Stats DeviceStatusStore::stats()
+    {
+        std::lock_guard locker(m_mutex);
+        return m_stats;
+    }
+
+    void DeviceStatusStore::load()
+    {
+        {
+            std::lock_guard locker(m_mutex);
+            if (m_loaded)
+            {
+                return;
+            }
+        }
+        // 数据库未就绪时不加载，之后的调用再尝试
+        if (!DatabaseManager::isReady())
+        {
+            return;
+        }
+
+        std::vector<device_status> latest;
+        {
+            DBConnectionGuard guard;
+            auto &db = guard.get();
+            if (!db.isOpen())
+            {
+                return;
+            }
+            QSqlQuery query(db);
+            query.setForwardOnly(true);
+            const bool ok =
+                db.driverName() == QLatin1String("QPSQL")
+                    ? query.exec("SELECT DISTINCT ON (tag) * FROM device_status ORDER BY tag, id DESC")
+                    : query.exec("SELECT d.* FROM device_status d JOIN (SELECT tag, MAX(id) AS id FROM device_status GROUP BY tag) m ON d.id = m.id");
+            if (!ok)
+            {
+                LogWarn("device status: load latest failed: {}", query.lastError().text().toStdString());
+                return;
+            }
+            const auto columns = OrmMapper<device_status>::resolve(query.record());
+            while (query.next())
+            {
+                latest.push_back(OrmMapper<device_status>::fromQuery(query, columns));
+            }
+        }
+
+        std::lock_guard locker(m_mutex);
+        if (m_loaded)
+        {
+            return;
+        }
+        // 加载前已上报的 tag 以内存中的值为准
+        for (auto &status : latest)
+        {
+            if (m_states.count(status.tag) == 0)
+            {
+                const auto persistedAt = status.created_time;
+                m_states[status.tag] = Entry{std::move(status), persistedAt};
+            }
+        }
+        m_loaded = true;
+        LogInfo("device status: loaded {} tags", latest.size());
+    }
+} // namespace _Kits
@@ -0,0 +1,66 @@
+#pragma once
+#include "kits/orm/TableStructs.h"
+#include <QDateTime>
+#include <QString>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+namespace _Kits
+{
+/**
+ * @brief 设备状态的最新值：按 tag 保存在内存中，device_status 只在状态变化时写入。
+ *
+ * - report() 与该 tag 上次的 details_json 比较，变化时经写后落库追加一行；不变时只更新内存中的采样时间，
+ *   距上次写库超过 database.device_status.keyframe_ms 时补写一行作为关键帧；
+ * - current() / currentAll() 直接返回内存中的值：created_time 为该值首次出现的时间，updated_time 为最近一次采样时间；
+ * - 首次使用且数据库就绪时，从库中取各 tag 最新一行作为初值，重启后值不变的采样不会重复写入。
+ *
+ * @code
+ * deviceStatus().report("disk", json);
+ * auto disk = deviceStatus().current("disk");
+ * @endcode
+ */
+class DeviceStatusStore
+{
+  public:
+    struct Stats
+    {
+        uint64_t reported = 0;  // 上报次数
+        uint64_t changed = 0;   // 值变化而写库
+        uint64_t keyframes = 0; // 值未变、按关键帧间隔写库
+        uint64_t unchanged = 0; // 值未变、未写库
+    };
+
+    static DeviceStatusStore &instance();
+
+    /// @brief 上报一次采样，返回本次是否写库
+    bool report(const QString &tag, const QString &detailsJson);
+    std::optional<device_status> current(const QString &tag);
+    std::vector<device_status> currentAll();
+    Stats stats();
+
+  private:
+    DeviceStatusStore() = default;
+
+    struct Entry
+    {
+        device_status status;
+        QDateTime persistedAt; // 最近一次写库（或从库中加载）的时间
+    };
+
+    void load();
+
+    std::mutex m_mutex;
+    std::unordered_map<QString, Entry> m_states;
+    bool m_loaded = false;
+    Stats m_stats;
+};
+
+inline DeviceStatusStore &deviceStatus()
+{
+    return DeviceStatusStore::instance();
+}
+} // namespace _Kits
@@ -1,4 +1,6 @@
 #include "MysqlConnections.h"
+#include "PointCloudMigration.h"
+#include <QCryptographicHash>
 #include <QFile>
 namespace _Kits
 {
@@ -7,8 +9,8 @@ MysqlConnections::MysqlConnections(const QString &host,
                                    const QString &dbName,
                                    const QString &user,
                                    const QString &password,
-                                   int maxConnections)
-    : DatabaseConnections(host, port, dbName, user, password, maxConnections)
+                                   const DatabasePoolOptions &options)
+    : DatabaseConnections(host, port, dbName, user, password, options)
 {
 }
 bool MysqlConnections::checkAndCreateDatabase()
@@ -63,13 +65,6 @@ bool MysqlConnections::checkAndCreateDatabase()
 
 bool MysqlConnections::initializeDatabaseSchema()
 {
-    auto db = createConnection();
-    if (!db.isOpen() || !db.isValid())
-    {
-        qDebug() << "Failed to connect to target database for initialization.";
-        return false;
-    }
-
     QFile sqlFile("./config/mysqlinit.sql");
     if (!sqlFile.open(QIODevice::ReadOnly | QIODevice::Text))
     {
@@ -87,37 +82,56 @@ bool MysqlConnections::initializeDatabaseSchema()
         return false;
     }
 
-    QStringList statements = script.split(";", Qt::SkipEmptyParts);
-    for (const QString &statement : statements)
+    auto db = createConnection();
+    if (!db.isOpen() || !db.isValid())
     {
-        if (statement.trimmed().isEmpty())
-            continue;
+        qDebug() << "Failed to connect to target database for initialization.";
+        return false;
+    }
 
-        QSqlQuery initQuery(db);
-        if (!initQuery.exec(statement.trimmed()))
+    // 脚本未变化时跳过逐条执行
+    const auto checksum = QCryptographicHash::hash(script.toUtf8(), QCryptographicHash::Sha256).toHex();
+    if (schemaStamped(db, "mysqlinit.sql", checksum))
+    {
+        qDebug() << "Database schema up to date, script skipped.";
+    }
+    else
+    {
+        QStringList statements = script.split(";", Qt::SkipEmptyParts);
+        for (const QString &statement : statements)
         {
-            qDebug() << "Failed to execute statement:" << statement.trimmed()
-                     << "Error:" << initQuery.lastError().text();
-            return false;
+            if (statement.trimmed().isEmpty())
+                continue;
+
+            QSqlQuery initQuery(db);
+            if (!initQuery.exec(statement.trimmed()))
+            {
+                qDebug() << "Failed to execute statement:" << statement.trimmed()
+                         << "Error:" << initQuery.lastError().text();
+                closeConnection(std::move(db));
+                return false;
+            }
         }
+        stampSchema(db, "mysqlinit.sql", checksum);
+        qDebug() << "Database initialized with SQL script successfully.";
     }
 
-    qDebug() << "Database initialized with SQL script successfully.";
+    PointCloudMigration::instance().ensureColumns(db);
+    closeConnection(std::move(db));
     return true;
 }
 
+// 连接按使用线程按需创建，这里只校验能否建立连接
 bool MysqlConnections::initializeConnectionPool()
 {
-    for (size_t i = 0; i < 5; i++)
+    auto connection = createConnection();
+    if (!connection.isOpen() || !connection.isValid())
     {
-        auto connection = createConnection();
-        if (!connection.isOpen() || !connection.isValid())
-        {
-            qDebug() << "Failed to create database connection for pool.";
-            return false;
-        }
-        connectionPool_.push_back(std::move(connection));
+        qDebug() << "Failed to create database connection for pool.";
+        return false;
     }
+    closeConnection(std::move(connection));
+    PointCloudMigration::instance().start();
 
     qDebug() << "Database connection pool initialized successfully.";
     return true;
@@ -140,7 +154,7 @@ QSqlDatabase MysqlConnections::createConnection()
         qDebug() << "create sql connection error, " << error;
         return {};
     }
-    qDebug() << "create sql connection size=" << count_;
+    qDebug() << "create sql connection size=" << count_.load();
     return db;
 }
 } // namespace _Kits
\ No newline at end of file
@@ -12,7 +12,7 @@ class MysqlConnections : public DatabaseConnections
                               const QString &dbName,
                               const QString &user,
                               const QString &password,
-                              int maxConnections = 5);
+                              const DatabasePoolOptions &options = {});
     virtual ~MysqlConnections() = default;
 
   public:
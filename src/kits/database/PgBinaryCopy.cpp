@@ -0,0 +1,367 @@
+#include "PgBinaryCopy.h"
+#include "PgsqlConnections.h"
+#include "kits/required/log/FlightRecorder.h"
+#include <QDateTime>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QTimeZone>
+#include <QUuid>
+#include <QtEndian>
+#include <cstring>
+#include <libpq-fe.h>
+#include <mutex>
+#include <unordered_map>
+
+namespace _Kits
+{
+    namespace
+    {
+        // pg_type.h 中的内置类型 OID
+        enum PgType : uint32_t
+        {
+            kBool = 16,
+            kBytea = 17,
+            kInt8 = 20,
+            kInt2 = 21,
+            kInt4 = 23,
+            kText = 25,
+            kJson = 114,
+            kFloat4 = 700,
+            kFloat8 = 701,
+            kBpchar = 1042,
+            kVarchar = 1043,
+            kDate = 1082,
+            kTimestamp = 1114,
+            kTimestampTz = 1184,
+            kUuid = 2950,
+            kJsonb = 3802,
+        };
+
+        constexpr char kSignature[] = "PGCOPY\n\377\r\n";
+        constexpr int64_t kPgEpochMs = 946684800000LL; // 2000-01-01T00:00:00Z
+
+        template <typename V>
+        void put(std::string &out, V value)
+        {
+            value = qToBigEndian(value);
+            out.append(reinterpret_cast<const char *>(&value), sizeof(value));
+        }
+
+        QDateTime toDateTime(const QVariant &value)
+        {
+            if (value.metaType().id() == QMetaType::QDateTime)
+            {
+                return value.toDateTime();
+            }
+            auto text = value.toString();
+            auto dt = QDateTime::fromString(text, "yyyy-MM-dd HH:mm:ss.zzz");
+            if (!dt.isValid())
+            {
+                dt = QDateTime::fromString(text, "yyyy-MM-dd HH:mm:ss");
+            }
+            if (!dt.isValid())
+            {
+                dt = QDateTime::fromString(text, Qt::ISODateWithMs);
+            }
+            return dt;
+        }
+
+        // 列类型缓存：表名 + 列名 -> 类型 OID
+        std::mutex g_typeMutex;
+        std::unordered_map<QString, std::vector<uint32_t>> g_typeCache;
+    } // namespace
+
+    PgBinaryCopy::PgBinaryCopy(QSqlDatabase &db, std::size_t bufferSize)
+        : m_db(db), m_conn(PgsqlConnections::nativeHandle(db)), m_bufferSize(bufferSize)
+    {
+        m_buffer.reserve(m_bufferSize + 4096);
+    }
+
+    PgBinaryCopy::~PgBinaryCopy()
+    {
+        if (m_active)
+        {
+            abort();
+        }
+    }
+
+    bool PgBinaryCopy::fail(const QString &error)
+    {
+        m_error = error;
+        return false;
+    }
+
+    bool PgBinaryCopy::loadColumnTypes(const QString &table, const QStringList &columns)
+    {
+        const QString key = table + ":" + columns.join(',');
+        {
+            std::lock_guard locker(g_typeMutex);
+            auto it = g_typeCache.find(key);
+            if (it != g_typeCache.end())
+            {
+                m_types = it->second;
+                return true;
+            }
+        }
+        QSqlQuery query(m_db);
+        query.prepare("SELECT attname, atttypid FROM pg_attribute "
+                      "WHERE attrelid = to_regclass(:table) AND attnum > 0 AND NOT attisdropped");
+        query.bindValue(":table", table);
+        if (!query.exec())
+        {
+            return fail(query.lastError().text());
+        }
+        std::unordered_map<QString, uint32_t> types;
+        while (query.next())
+        {
+            types.emplace(query.value(0).toString(), query.value(1).toUInt());
+        }
+        m_types.clear();
+        for (const auto &column : columns)
+        {
+            auto it = types.find(column);
+            if (it == types.end())
+            {
+                return fail(QString("column %1.%2 not found").arg(table, column));
+            }
+            m_types.push_back(it->second);
+        }
+        std::lock_guard locker(g_typeMutex);
+        g_typeCache[key] = m_types;
+        return true;
+    }
+
+    bool PgBinaryCopy::begin(const QString &table, const QStringList &columns)
+    {
+        if (m_conn == nullptr)
+        {
+            return fail("not a PostgreSQL connection");
+        }
+        if (!loadColumnTypes(table, columns))
+        {
+            return false;
+        }
+        // 先用空值探测一遍类型是否支持，避免发送到一半才失败
+        for (std::size_t i = 0; i < m_types.size(); ++i)
+        {
+            m_field.clear();
+            if (!encodeField(m_types[i], QVariant(), m_field))
+            {
+                return fail(QString("unsupported column type oid %1 for %2").arg(m_types[i]).arg(columns[i]));
+            }
+        }
+
+        QString sql = QString("COPY %1 (%2) FROM STDIN (FORMAT binary)").arg(table, columns.join(", "));
+        if (FlightRecorder::instance().isOpen())
+        {
+            flightEvent(FlightKind::database, sql.toStdString());
+        }
+        PGresult *result = PQexec(m_conn, sql.toUtf8().constData());
+        bool ok = PQresultStatus(result) == PGRES_COPY_IN;
+        if (!ok)
+        {
+            fail(QString::fromUtf8(PQresultErrorMessage(result)));
+        }
+        PQclear(result);
+        if (!ok)
+        {
+            return false;
+        }
+
+        m_active = true;
+        m_rows = 0;
+        m_buffer.clear();
+        m_buffer.append(kSignature, sizeof(kSignature) - 1);
+        m_buffer.push_back('\0');
+        put<int32_t>(m_buffer, 0); // flags
+        put<int32_t>(m_buffer, 0); // 头部扩展长度
+        return true;
+    }
+
+    bool PgBinaryCopy::addRow(const std::vector<QVariant> &values)
+    {
+        if (!m_active)
+        {
+            return fail("copy not started");
+        }
+        if (values.size() != m_types.size())
+        {
+            return fail("column count mismatch");
+        }
+        put<int16_t>(m_buffer, static_cast<int16_t>(values.size()));
+        for (std::size_t i = 0; i < values.size(); ++i)
+        {
+            if (values[i].isNull())
+            {
+                put<int32_t>(m_buffer, -1);
+                continue;
+            }
+            m_field.clear();
+            if (!encodeField(m_types[i], values[i], m_field))
+            {
+                return fail(QString("cannot encode value for column %1").arg(i));
+            }
+            put<int32_t>(m_buffer, static_cast<int32_t>(m_field.size()));
+            m_buffer.append(m_field);
+        }
+        ++m_rows;
+        if (m_buffer.size() >= m_bufferSize)
+        {
+            return sendBuffer();
+        }
+        return true;
+    }
+
+    bool PgBinaryCopy::sendBuffer()
+    {
+        if (m_buffer.empty())
+        {
+            return true;
+        }
+        if (PQputCopyData(m_conn, m_buffer.data(), static_cast<int>(m_buffer.size())) != 1)
+        {
+            return fail(QString::fromUtf8(PQerrorMessage(m_conn)));
+        }
+        m_buffer.clear();
+        return true;
+    }
+
+    int64_t PgBinaryCopy::end()
+    {
+        if (!m_active)
+        {
+            return -1;
+        }
+        put<int16_t>(m_buffer, -1); // 文件尾
+        m_active = false;
+        if (!sendBuffer())
+        {
+            PQputCopyEnd(m_conn, "send failed");
+        }
+        else if (PQputCopyEnd(m_conn, nullptr) != 1)
+        {
+            fail(QString::fromUtf8(PQerrorMessage(m_conn)));
+        }
+        bool ok = true;
+        while (PGresult *result = PQgetResult(m_conn))
+        {
+            if (PQresultStatus(result) != PGRES_COMMAND_OK)
+            {
+                ok = false;
+                fail(QString::fromUtf8(PQresultErrorMessage(result)));
+            }
+            PQclear(result);
+        }
+        return ok ? m_rows : -1;
+    }
+
+    void PgBinaryCopy::abort()
+    {
+        m_active = false;
+        PQputCopyEnd(m_conn, "aborted");
+        while (PGresult *result = PQgetResult(m_conn))
+        {
+            PQclear(result);
+        }
+    }
+
+    bool PgBinaryCopy::encodeField(uint32_t typeOid, const QVariant &value, std::string &out)
+    {
+        // 空值只用于类型探测
+        const bool probe = !value.isValid();
+        switch (typeOid)
+        {
+        case kBool:
+            if (!probe)
+                out.push_back(value.toBool() ? 1 : 0);
+            return true;
+        case kInt2:
+            if (!probe)
+                put<int16_t>(out, static_cast<int16_t>(value.toInt()));
+            return true;
+        case kInt4:
+            if (!probe)
+                put<int32_t>(out, value.toInt());
+            return true;
+        case kInt8:
+            if (!probe)
+                put<int64_t>(out, value.toLongLong());
+            return true;
+        case kFloat4:
+            if (!probe)
+            {
+                float f = value.toFloat();
+                uint32_t bits;
+                std::memcpy(&bits, &f, sizeof(bits));
+                put<uint32_t>(out, bits);
+            }
+            return true;
+        case kFloat8:
+            if (!probe)
+            {
+                double d = value.toDouble();
+                uint64_t bits;
+                std::memcpy(&bits, &d, sizeof(bits));
+                put<uint64_t>(out, bits);
+            }
+            return true;
+        case kText:
+        case kVarchar:
+        case kBpchar:
+        case kJson:
+            if (!probe)
+            {
+                auto utf8 = value.toString().toUtf8();
+                out.append(utf8.constData(), utf8.size());
+            }
+            return true;
+        case kJsonb:
+            if (!probe)
+            {
+                auto utf8 = value.toString().toUtf8();
+                out.push_back(1); // jsonb 二进制格式版本号
+                out.append(utf8.constData(), utf8.size());
+            }
+            return true;
+        case kBytea:
+            if (!probe)
+            {
+                auto bytes = value.toByteArray();
+                out.append(bytes.constData(), bytes.size());
+            }
+            return true;
+        case kUuid:
+            if (!probe)
+            {
+                auto bytes = QUuid::fromString(value.toString()).toRfc4122();
+                out.append(bytes.constData(), bytes.size());
+            }
+            return true;
+        case kDate:
+            if (!probe)
+            {
+                auto date = value.metaType().id() == QMetaType::QDate ? value.toDate() : toDateTime(value).date();
+                if (!date.isValid())
+                    return false;
+                put<int32_t>(out, static_cast<int32_t>(QDate(2000, 1, 1).daysTo(date)));
+            }
+            return true;
+        case kTimestamp:
+        case kTimestampTz:
+            if (!probe)
+            {
+                auto dt = toDateTime(value);
+                if (!dt.isValid())
+                    return false;
+                int64_t ms = dt.toMSecsSinceEpoch();
+                // timestamp 不带时区，存储的是本地墙上时间
+                if (typeOid == kTimestamp)
+                    ms += static_cast<int64_t>(dt.offsetFromUtc()) * 1000;
+                put<int64_t>(out, (ms - kPgEpochMs) * 1000);
+            }
+            return true;
+        default:
+            return false;
+        }
+    }
+} // namespace _Kits
@@ -0,0 +1,58 @@
+#pragma once
+#include <QByteArray>
+#include <QSqlDatabase>
+#include <QString>
+#include <QStringList>
+#include <QVariant>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+typedef struct pg_conn PGconn;
+
+namespace _Kits
+{
+/**
+ * @brief PostgreSQL 二进制 COPY 写入器，直接使用 QPSQL 连接底层的 libpq 句柄。
+ *
+ * 列类型从系统表读取，每个字段按列类型编码为二进制格式，数据攒满缓冲后经
+ * PQputCopyData 发送，整批只有一次往返，服务端不做文本解析。
+ *
+ * 支持的列类型：bool/int2/int4/int8/float4/float8/text/varchar/bpchar/
+ * json/jsonb/bytea/date/timestamp/timestamptz/uuid；遇到不支持的类型时 begin() 返回 false。
+ */
+class PgBinaryCopy
+{
+  public:
+    explicit PgBinaryCopy(QSqlDatabase &db, std::size_t bufferSize = 1024 * 1024);
+    ~PgBinaryCopy();
+
+    bool begin(const QString &table, const QStringList &columns);
+    bool addRow(const std::vector<QVariant> &values);
+    /// @brief 结束 COPY 并返回写入行数，失败时返回 -1
+    int64_t end();
+    void abort();
+    const QString &lastError() const
+    {
+        return m_error;
+    }
+
+    /// @brief 按列类型 OID 编码单个字段（不含长度前缀），供测试与复用
+    static bool encodeField(uint32_t typeOid, const QVariant &value, std::string &out);
+
+  private:
+    bool loadColumnTypes(const QString &table, const QStringList &columns);
+    bool sendBuffer();
+    bool fail(const QString &error);
+
+    QSqlDatabase &m_db;
+    PGconn *m_conn = nullptr;
+    std::vector<uint32_t> m_types;
+    std::string m_buffer;
+    std::string m_field;
+    std::size_t m_bufferSize;
+    int64_t m_rows = 0;
+    bool m_active = false;
+    QString m_error;
+};
+} // namespace _Kits
@@ -0,0 +1,348 @@
+#include "PgPartitions.h"
+#include "DatabaseManager.h"
+#include "QueryResultCache.h"
+#include "kits/required/log/CRossLogger.h"
+#include <QRegularExpression>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QStringList>
+#include <algorithm>
+#include <chrono>
+
+namespace _Kits
+{
+    namespace
+    {
+        bool monthly(const PartitionPolicy &policy)
+        {
+            return policy.interval == "month";
+        }
+
+        // 包含 date 的分区区间起点
+        QDate periodStart(const PartitionPolicy &policy, const QDate &date)
+        {
+            return monthly(policy) ? QDate(date.year(), date.month(), 1) : date;
+        }
+
+        QDate periodNext(const PartitionPolicy &policy, const QDate &start)
+        {
+            return monthly(policy) ? start.addMonths(1) : start.addDays(1);
+        }
+
+        QString partitionName(const PartitionPolicy &policy, const QDate &start)
+        {
+            return QString("%1_p%2").arg(QString::fromStdString(policy.table),
+                                         start.toString(monthly(policy) ? "yyyyMM" : "yyyyMMdd"));
+        }
+
+        // 区间 [a1, a2) 与 [b1, b2) 是否相交，无效日期表示无界
+        bool overlaps(const QDate &a1, const QDate &a2, const QDate &b1, const QDate &b2)
+        {
+            bool aBeforeB = a2.isValid() && b1.isValid() && a2 <= b1;
+            bool bBeforeA = b2.isValid() && a1.isValid() && b2 <= a1;
+            return !aBeforeB && !bBeforeA;
+        }
+    } // namespace
+
+    PgPartitions &PgPartitions::instance()
+    {
+        static PgPartitions partitions;
+        return partitions;
+    }
+
+    PgPartitions::~PgPartitions()
+    {
+        stop();
+    }
+
+    void PgPartitions::start()
+    {
+        if (m_running.exchange(true))
+        {
+            return;
+        }
+        m_worker = std::thread([this]() {
+            while (m_running)
+            {
+                const auto minutes = std::max(ConfigService::instance().snapshot()->database.partitionMaintainMinutes, 1);
+                {
+                    std::unique_lock locker(m_mutex);
+                    m_cv.wait_for(locker, std::chrono::minutes(minutes), [this] { return !m_running; });
+                }
+                if (!m_running)
+                {
+                    break;
+                }
+                DBConnectionGuard guard;
+                if (guard.get().isOpen())
+                {
+                    maintain(guard.get());
+                }
+            }
+        });
+    }
+
+    void PgPartitions::stop()
+    {
+        if (!m_running.exchange(false))
+        {
+            return;
+        }
+        m_cv.notify_all();
+        if (m_worker.joinable())
+        {
+            m_worker.join();
+        }
+    }
+
+    bool PgPartitions::maintain(QSqlDatabase &db)
+    {
+        const auto config = ConfigService::instance().snapshot();
+        if (config->database.partitions.empty())
+        {
+            return true;
+        }
+        // DDL 需要父表的锁，等不到就放弃，避免阻塞写入
+        execute(db, "SET lock_timeout = '3s'");
+        bool ok = true;
+        for (const auto &policy : config->database.partitions)
+        {
+            ok = maintainTable(db, policy) && ok;
+        }
+        execute(db, "RESET lock_timeout");
+        return ok;
+    }
+
+    bool PgPartitions::maintainTable(QSqlDatabase &db, const PartitionPolicy &policy)
+    {
+        if (!ensurePartitioned(db, policy))
+        {
+            return false;
+        }
+        bool ok = createAhead(db, policy, partitions(db, QString::fromStdString(policy.table)));
+        if (policy.retainDays > 0)
+        {
+            ok = enforceRetention(db, policy, partitions(db, QString::fromStdString(policy.table))) && ok;
+        }
+        return ok;
+    }
+
+    bool PgPartitions::ensurePartitioned(QSqlDatabase &db, const PartitionPolicy &policy)
+    {
+        QSqlQuery query(db);
+        query.prepare("SELECT c.relkind FROM pg_class c JOIN pg_namespace n ON n.oid = c.relnamespace "
+                      "WHERE c.relname = ? AND n.nspname = current_schema()");
+        query.addBindValue(QString::fromStdString(policy.table));
+        if (!query.exec())
+        {
+            LogWarn("partition: query {} failed: {}", policy.table, query.lastError().text().toStdString());
+            return false;
+        }
+        if (!query.next())
+        {
+            LogWarn("partition: table {} does not exist", policy.table);
+            return false;
+        }
+        const auto kind = query.value(0).toString();
+        if (kind == "p")
+        {
+            return true;
+        }
+        if (kind != "r")
+        {
+            LogWarn("partition: {} is not a table (relkind {})", policy.table, kind.toStdString());
+            return false;
+        }
+        return convertToPartitioned(db, policy);
+    }
+
+    bool PgPartitions::convertToPartitioned(QSqlDatabase &db, const PartitionPolicy &policy)
+    {
+        const auto table = QString::fromStdString(policy.table);
+        const auto column = QString::fromStdString(policy.column);
+        const auto legacy = table + "_legacy";
+        LogInfo("partition: converting {} to a partitioned table on {}", policy.table, policy.column);
+
+        // 原表数据的上界：最新一行所在区间的下一个区间起点
+        QSqlQuery query(db);
+        if (!query.exec(QString("SELECT MAX(%1)::timestamp FROM %2").arg(column, table)))
+        {
+            LogWarn("partition: read max({}) of {} failed: {}", policy.column, policy.table, query.lastError().text().toStdString());
+            return false;
+        }
+        QDate latest = query.next() && !query.isNull(0) ? query.value(0).toDateTime().date() : QDate::currentDate();
+        latest = std::max(latest, QDate::currentDate());
+        const QDate upper = periodNext(policy, periodStart(policy, latest));
+
+        QString sequence;
+        if (query.exec(QString("SELECT pg_get_serial_sequence('%1', 'id')").arg(table)) && query.next())
+        {
+            sequence = query.value(0).toString();
+        }
+        QStringList indexes;
+        query.prepare("SELECT indexdef FROM pg_indexes WHERE schemaname = current_schema() AND tablename = ? "
+                      "AND indexdef NOT LIKE 'CREATE UNIQUE%'");
+        query.addBindValue(table);
+        if (query.exec())
+        {
+            static const QRegularExpression prefix("^CREATE INDEX \\S+ ON \\S+ ");
+            while (query.next())
+            {
+                indexes << query.value(0).toString().replace(prefix, QString("CREATE INDEX ON %1 ").arg(table));
+            }
+        }
+
+        QStringList steps;
+        steps << QString("ALTER TABLE %1 RENAME TO %2").arg(table, legacy)
+              << QString("CREATE TABLE %1 (LIKE %2 INCLUDING DEFAULTS INCLUDING CONSTRAINTS INCLUDING STORAGE INCLUDING COMMENTS) "
+                         "PARTITION BY RANGE (%3)")
+                     .arg(table, legacy, column)
+              << QString("ALTER TABLE %1 ADD PRIMARY KEY (id, %2)").arg(table, column);
+        if (!sequence.isEmpty())
+        {
+            // 序列随原表删除，改为属于新表
+            steps << QString("ALTER SEQUENCE %1 OWNED BY %2.id").arg(sequence, table);
+        }
+        // 分区键不能为空：先补齐空值；再加与分区范围一致的 CHECK 约束，SET NOT NULL 与 ATTACH 都据此跳过全表校验。
+        // 约束在建新表之后再加，以免被 LIKE ... INCLUDING CONSTRAINTS 复制到新表
+        const auto bound = legacy + "_partition_bound";
+        steps << QString("UPDATE %1 SET %2 = CURRENT_TIMESTAMP WHERE %2 IS NULL").arg(legacy, column)
+              << QString("ALTER TABLE %1 ADD CONSTRAINT %2 CHECK (%3 IS NOT NULL AND %3 < '%4')")
+                     .arg(legacy, bound, column, upper.toString(Qt::ISODate))
+              << QString("ALTER TABLE %1 ALTER COLUMN %2 SET NOT NULL").arg(legacy, column)
+              << QString("ALTER TABLE %1 ATTACH PARTITION %2 FOR VALUES FROM (MINVALUE) TO ('%3')")
+                     .arg(table, legacy, upper.toString(Qt::ISODate))
+              << QString("ALTER TABLE %1 DROP CONSTRAINT %2").arg(legacy, bound);
+        steps << indexes;
+
+        if (!db.transaction())
+        {
+            return false;
+        }
+        for (const auto &step : steps)
+        {
+            if (!execute(db, step))
+            {
+                db.rollback();
+                return false;
+            }
+        }
+        if (!db.commit())
+        {
+            LogWarn("partition: convert {} commit failed: {}", policy.table, db.lastError().text().toStdString());
+            return false;
+        }
+        QueryResultCache::instance().invalidate(table);
+        return true;
+    }
+
+    bool PgPartitions::createAhead(QSqlDatabase &db, const PartitionPolicy &policy, const std::vector<Partition> &existing)
+    {
+        const auto table = QString::fromStdString(policy.table);
+        bool ok = true;
+        bool hasDefault = std::any_of(existing.begin(), existing.end(), [](const Partition &p) { return p.isDefault; });
+        if (!hasDefault)
+        {
+            // 兜底分区：时钟异常等超出预建范围的数据也能写入
+            ok = execute(db, QString("CREATE TABLE IF NOT EXISTS %1_default PARTITION OF %1 DEFAULT").arg(table));
+        }
+        QDate start = periodStart(policy, QDate::currentDate());
+        for (int i = 0; i < std::max(policy.premake, 1); ++i, start = periodNext(policy, start))
+        {
+            const QDate end = periodNext(policy, start);
+            bool covered = std::any_of(existing.begin(), existing.end(), [&](const Partition &p) {
+                return !p.isDefault && overlaps(p.from, p.to, start, end);
+            });
+            if (covered)
+            {
+                continue;
+            }
+            ok = execute(db, QString("CREATE TABLE IF NOT EXISTS %1 PARTITION OF %2 FOR VALUES FROM ('%3') TO ('%4')")
+                                 .arg(partitionName(policy, start), table, start.toString(Qt::ISODate), end.toString(Qt::ISODate))) &&
+                 ok;
+        }
+        return ok;
+    }
+
+    bool PgPartitions::enforceRetention(QSqlDatabase &db, const PartitionPolicy &policy, const std::vector<Partition> &existing)
+    {
+        const auto table = QString::fromStdString(policy.table);
+        const QDate cutoff = QDate::currentDate().addDays(-policy.retainDays);
+        bool ok = true;
+        bool removed = false;
+        for (const auto &partition : existing)
+        {
+            if (partition.isDefault || !partition.to.isValid() || partition.to > cutoff)
+            {
+                continue;
+            }
+            const auto sql = policy.detach ? QString("ALTER TABLE %1 DETACH PARTITION %2").arg(table, partition.name)
+                                           : QString("DROP TABLE %1").arg(partition.name);
+            if (execute(db, sql))
+            {
+                LogInfo("partition: {} {} (before {})",
+                        policy.detach ? "detached" : "dropped",
+                        partition.name.toStdString(),
+                        partition.to.toString(Qt::ISODate).toStdString());
+                removed = true;
+            }
+            else
+            {
+                ok = false;
+            }
+        }
+        if (removed)
+        {
+            QueryResultCache::instance().invalidate(table);
+        }
+        return ok;
+    }
+
+    std::vector<PgPartitions::Partition> PgPartitions::partitions(QSqlDatabase &db, const QString &table)
+    {
+        std::vector<Partition> result;
+        QSqlQuery query(db);
+        query.prepare("SELECT c.relname, pg_get_expr(c.relpartbound, c.oid) FROM pg_inherits i "
+                      "JOIN pg_class c ON c.oid = i.inhrelid JOIN pg_class p ON p.oid = i.inhparent "
+                      "JOIN pg_namespace n ON n.oid = p.relnamespace "
+                      "WHERE p.relname = ? AND n.nspname = current_schema()");
+        query.addBindValue(table);
+        if (!query.exec())
+        {
+            LogWarn("partition: list partitions of {} failed: {}", table.toStdString(), query.lastError().text().toStdString());
+            return result;
+        }
+        // FOR VALUES FROM ('2026-10-19 00:00:00') TO ('2026-10-20 00:00:00') / FROM (MINVALUE) TO (...)
+        static const QRegularExpression bound(R"(FROM \((?:'([^']*)'|MINVALUE)\) TO \((?:'([^']*)'|MAXVALUE)\))");
+        while (query.next())
+        {
+            Partition partition;
+            partition.name = query.value(0).toString();
+            const auto expr = query.value(1).toString();
+            partition.isDefault = expr == "DEFAULT";
+            auto match = bound.match(expr);
+            if (match.hasMatch())
+            {
+                partition.from = QDate::fromString(match.captured(1).left(10), Qt::ISODate);
+                partition.to = QDate::fromString(match.captured(2).left(10), Qt::ISODate);
+            }
+            else if (!partition.isDefault)
+            {
+                continue; // 非范围分区，不由这里管理
+            }
+            result.push_back(std::move(partition));
+        }
+        return result;
+    }
+
+    bool PgPartitions::execute(QSqlDatabase &db, const QString &sql)
+    {
+        QSqlQuery query(db);
+        if (!query.exec(sql))
+        {
+            LogWarn("partition: {} failed: {}", sql.toStdString(), query.lastError().text().toStdString());
+            return false;
+        }
+        return true;
+    }
+} // namespace _Kits
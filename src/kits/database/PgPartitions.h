@@ -0,0 +1,70 @@
+#pragma once
+#include "kits/required/config/ConfigService.h"
+#include <QDate>
+#include <QSqlDatabase>
+#include <QString>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace _Kits
+{
+/**
+ * @brief PostgreSQL 按时间范围分区的维护：建分区、提前建分区、按保留期删除/分离分区。
+ *
+ * 策略来自 config.yaml 的 database.partitions，例如：
+ * @code
+ * database:
+ *   partition_maintain_minutes: 60
+ *   partitions:
+ *     - { table: radar_data, interval: day, premake: 3, retain_days: 30, retention: drop }
+ *     - { table: arc_data, column: created_time, interval: month, retain_days: 365, retention: detach }
+ * @endcode
+ *
+ * - 普通表首次维护时转为分区表：原表改名为 <表名>_legacy，作为覆盖至今数据的分区挂入，
+ *   主键改为 (id, 分区键)，非唯一索引在父表上重建；
+ * - 分区命名 <表名>_pYYYYMMDD（按天）或 <表名>_pYYYYMM（按月），另有 <表名>_default 兜底；
+ * - 上界早于保留期的分区整体 DROP（或 DETACH），不产生 DELETE 的膨胀。
+ *
+ * 查询带分区键的范围条件（见 SqlSelect::during）时，PostgreSQL 只扫描相关分区。
+ * DDL 以 lock_timeout 执行，拿不到锁则留到下个周期。
+ */
+class PgPartitions
+{
+  public:
+    static PgPartitions &instance();
+    ~PgPartitions();
+
+    /// @brief 按当前配置维护全部分区表，返回是否全部成功
+    bool maintain(QSqlDatabase &db);
+    /// @brief 启动周期维护线程（连接取自连接池）
+    void start();
+    void stop();
+
+  private:
+    struct Partition
+    {
+        QString name;
+        bool isDefault = false;
+        QDate from; // 无效表示 MINVALUE
+        QDate to;   // 无效表示 MAXVALUE
+    };
+
+    PgPartitions() = default;
+
+    bool maintainTable(QSqlDatabase &db, const PartitionPolicy &policy);
+    bool ensurePartitioned(QSqlDatabase &db, const PartitionPolicy &policy);
+    bool convertToPartitioned(QSqlDatabase &db, const PartitionPolicy &policy);
+    bool createAhead(QSqlDatabase &db, const PartitionPolicy &policy, const std::vector<Partition> &existing);
+    bool enforceRetention(QSqlDatabase &db, const PartitionPolicy &policy, const std::vector<Partition> &existing);
+    static std::vector<Partition> partitions(QSqlDatabase &db, const QString &table);
+    static bool execute(QSqlDatabase &db, const QString &sql);
+
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    std::atomic<bool> m_running{false};
+    std::thread m_worker;
+};
+} // namespace _Kits
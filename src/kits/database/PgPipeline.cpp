@@ -0,0 +1,277 @@
+#include "PgPipeline.h"
+#include "PgsqlConnections.h"
+#include "QueryResultCache.h"
+#include "kits/required/log/CRossLogger.h"
+#include "kits/required/log/FlightRecorder.h"
+#include <QDateTime>
+#include <algorithm>
+#include <cstdlib>
+#include <libpq-fe.h>
+
+namespace _Kits
+{
+    PgPipeline::PgPipeline(QSqlDatabase &db, int window)
+        : m_db(db), m_conn(PgsqlConnections::nativeHandle(db)), m_window(std::max(window, 1))
+    {
+    }
+
+    std::size_t PgPipeline::add(const QString &sql, const QVariantList &params)
+    {
+        Statement statement;
+        statement.sql = sql.toUtf8();
+        statement.params.reserve(params.size());
+        statement.nulls.reserve(params.size());
+        for (const auto &param : params)
+        {
+            statement.nulls.push_back(param.isNull());
+            switch (param.metaType().id())
+            {
+            case QMetaType::Bool:
+                statement.params.push_back(param.toBool() ? "t" : "f");
+                break;
+            case QMetaType::QDateTime:
+                statement.params.push_back(param.toDateTime().toString(Qt::ISODateWithMs).toUtf8());
+                break;
+            default:
+                statement.params.push_back(param.toString().toUtf8());
+                break;
+            }
+        }
+        m_statements.push_back(std::move(statement));
+        return m_statements.size() - 1;
+    }
+
+    void PgPipeline::clear()
+    {
+        m_statements.clear();
+        m_results.clear();
+        m_error.clear();
+    }
+
+    bool PgPipeline::send(const Statement &statement)
+    {
+        std::vector<const char *> values(statement.params.size());
+        for (std::size_t i = 0; i < values.size(); ++i)
+        {
+            values[i] = statement.nulls[i] ? nullptr : statement.params[i].constData();
+        }
+        return PQsendQueryParams(m_conn,
+                                 statement.sql.constData(),
+                                 static_cast<int>(values.size()),
+                                 nullptr,
+                                 values.data(),
+                                 nullptr,
+                                 nullptr,
+                                 0) == 1;
+    }
+
+    void PgPipeline::read(PgStatementResult &result)
+    {
+        // 每条语句的结果以 nullptr 结束
+        bool first = true;
+        while (PGresult *pgResult = PQgetResult(m_conn))
+        {
+            if (first)
+            {
+                first = false;
+                switch (PQresultStatus(pgResult))
+                {
+                case PGRES_COMMAND_OK:
+                    result.ok = true;
+                    result.rowsAffected = std::atoll(PQcmdTuples(pgResult));
+                    break;
+                case PGRES_TUPLES_OK:
+                {
+                    result.ok = true;
+                    const int rows = PQntuples(pgResult);
+                    const int fields = PQnfields(pgResult);
+                    result.rowsAffected = rows;
+                    result.rows.reserve(rows);
+                    for (int r = 0; r < rows; ++r)
+                    {
+                        QStringList row;
+                        row.reserve(fields);
+                        for (int f = 0; f < fields; ++f)
+                        {
+                            row << (PQgetisnull(pgResult, r, f) ? QString() : QString::fromUtf8(PQgetvalue(pgResult, r, f)));
+                        }
+                        result.rows.push_back(std::move(row));
+                    }
+                    break;
+                }
+                case PGRES_PIPELINE_ABORTED:
+                    result.aborted = true;
+                    result.error = "aborted by an earlier error in the pipeline";
+                    break;
+                default:
+                    result.error = QString::fromUtf8(PQresultErrorMessage(pgResult)).trimmed();
+                    break;
+                }
+            }
+            PQclear(pgResult);
+        }
+        if (first)
+        {
+            result.error = QString::fromUtf8(PQerrorMessage(m_conn)).trimmed();
+        }
+    }
+
+    bool PgPipeline::readSync()
+    {
+        PGresult *pgResult = PQgetResult(m_conn);
+        bool ok = pgResult != nullptr && PQresultStatus(pgResult) == PGRES_PIPELINE_SYNC;
+        PQclear(pgResult);
+        return ok;
+    }
+
+    bool PgPipeline::leavePipeline()
+    {
+        if (PQexitPipelineMode(m_conn) == 1)
+        {
+            return true;
+        }
+        // 中途失败时还有未读的结果：补一个同步点使服务端发出全部结果，读到同步点后再退出；
+        // 连接已断开时不再读取
+        if (PQstatus(m_conn) != CONNECTION_OK || PQpipelineSync(m_conn) != 1)
+        {
+            return false;
+        }
+        // 空闲时 PQgetResult 连续返回 nullptr
+        int nulls = 0;
+        while (nulls < 2)
+        {
+            PGresult *pgResult = PQgetResult(m_conn);
+            if (pgResult == nullptr)
+            {
+                ++nulls;
+                continue;
+            }
+            nulls = 0;
+            const bool sync = PQresultStatus(pgResult) == PGRES_PIPELINE_SYNC;
+            PQclear(pgResult);
+            if (sync && PQexitPipelineMode(m_conn) == 1)
+            {
+                return true;
+            }
+        }
+        return PQexitPipelineMode(m_conn) == 1;
+    }
+
+    int PgPipeline::exec(bool transaction)
+    {
+        m_results.assign(m_statements.size(), {});
+        if (m_conn == nullptr)
+        {
+            m_error = "not a PostgreSQL connection";
+            return -1;
+        }
+        if (m_statements.empty())
+        {
+            return 0;
+        }
+        if (PQenterPipelineMode(m_conn) != 1)
+        {
+            m_error = QString::fromUtf8(PQerrorMessage(m_conn)).trimmed();
+            return -1;
+        }
+        if (FlightRecorder::instance().isOpen())
+        {
+            flightEvent(FlightKind::database,
+                        QString("pipeline %1 statements: %2").arg(m_statements.size()).arg(QString::fromUtf8(m_statements.front().sql)).toStdString());
+        }
+
+        // 事务模式下首尾追加 BEGIN/COMMIT，下标 -1 表示内部语句
+        std::vector<long> order;
+        order.reserve(m_statements.size() + 2);
+        if (transaction)
+            order.push_back(-1);
+        for (std::size_t i = 0; i < m_statements.size(); ++i)
+            order.push_back(static_cast<long>(i));
+        if (transaction)
+            order.push_back(-2);
+        const Statement begin{"BEGIN", {}, {}};
+        const Statement commit{"COMMIT", {}, {}};
+
+        bool broken = false;
+        bool failed = false;
+        for (std::size_t start = 0; start < order.size() && !broken; start += m_window)
+        {
+            const auto end = std::min(order.size(), start + static_cast<std::size_t>(m_window));
+            // 发送一个窗口的语句；非事务模式每条语句后加同步点，使失败只影响自身
+            std::size_t sent = start;
+            for (; sent < end; ++sent)
+            {
+                const auto index = order[sent];
+                const auto &statement = index == -1 ? begin : index == -2 ? commit : m_statements[index];
+                if (!send(statement) || (!transaction && PQpipelineSync(m_conn) != 1))
+                {
+                    broken = true;
+                    break;
+                }
+            }
+            if (transaction && !broken && PQpipelineSync(m_conn) != 1)
+            {
+                broken = true;
+            }
+            if (broken)
+            {
+                m_error = QString::fromUtf8(PQerrorMessage(m_conn)).trimmed();
+            }
+            // 读取已发送语句的结果
+            for (auto i = start; i < sent; ++i)
+            {
+                PgStatementResult internal;
+                auto &result = order[i] < 0 ? internal : m_results[order[i]];
+                read(result);
+                failed = failed || !result.ok;
+                if (!transaction && !readSync())
+                {
+                    broken = true;
+                }
+            }
+            if (transaction && sent == end && !broken && !readSync())
+            {
+                broken = true;
+            }
+        }
+        if (!leavePipeline())
+        {
+            // 连接仍处于 pipeline 模式，不能再交给其他查询使用
+            m_error = QString::fromUtf8(PQerrorMessage(m_conn)).trimmed();
+            LogWarn("pipeline: cannot leave pipeline mode, closing connection: {}", m_error.toStdString());
+            m_db.close();
+            m_conn = nullptr;
+            broken = true;
+        }
+
+        // 写语句清除目标表的结果缓存，连续相同的语句只处理一次
+        const QByteArray *previous = nullptr;
+        for (const auto &statement : m_statements)
+        {
+            if (previous == nullptr || *previous != statement.sql)
+            {
+                QueryResultCache::instance().invalidateForSql(QString::fromUtf8(statement.sql));
+                previous = &statement.sql;
+            }
+        }
+
+        int failures = 0;
+        for (auto &result : m_results)
+        {
+            // 事务内任一失败则全部回滚
+            if (transaction && failed && result.ok)
+            {
+                result.ok = false;
+                result.aborted = true;
+                result.error = "rolled back";
+            }
+            if (!result.ok)
+            {
+                if (result.error.isEmpty())
+                    result.error = broken ? m_error : QString("not executed");
+                ++failures;
+            }
+        }
+        return failures;
+    }
+} // namespace _Kits
@@ -0,0 +1,90 @@
+#pragma once
+#include <QByteArray>
+#include <QSqlDatabase>
+#include <QString>
+#include <QStringList>
+#include <QVariant>
+#include <QVariantList>
+#include <cstdint>
+#include <vector>
+
+typedef struct pg_conn PGconn;
+
+namespace _Kits
+{
+struct PgStatementResult
+{
+    bool ok = false;
+    bool aborted = false;      // 同一批次内之前的语句失败，未执行或已回滚
+    int64_t rowsAffected = 0;
+    QString error;
+    std::vector<QStringList> rows; // 查询语句的结果（文本格式）
+};
+
+/**
+ * @brief libpq pipeline 模式批量执行器（需 libpq 14+），用于大量小语句。
+ *
+ * 语句连续发送，不等待上一条的结果，结果按提交顺序异步读取，
+ * 整批只需约 (语句数 / window) 次往返。每条语句单独报告成功、失败或被中止。
+ * 参数以 $1、$2... 占位，按文本格式传递。
+ *
+ * - transaction = false：每条语句独立提交，失败不影响其他语句；
+ * - transaction = true：整批在一个事务内，任一失败则全部回滚。
+ *
+ * 执行后连接无法退出 pipeline 模式时将其关闭，归还连接池时随之丢弃。
+ *
+ * @code
+ * PgPipeline pipeline(guard.get());
+ * pipeline.add("UPDATE task_data SET line_dir = $1 WHERE id = $2", {dir, id});
+ * pipeline.add("INSERT INTO device_status (tag, details_json) VALUES ($1, $2)", {tag, json});
+ * int failed = pipeline.exec();
+ * @endcode
+ */
+class PgPipeline
+{
+  public:
+    explicit PgPipeline(QSqlDatabase &db, int window = 256);
+
+    bool isSupported() const
+    {
+        return m_conn != nullptr;
+    }
+    /// @brief 加入一条语句，返回其在结果中的下标
+    std::size_t add(const QString &sql, const QVariantList &params = {});
+    /// @brief 执行全部语句，返回失败条数；无法进入 pipeline 模式时返回 -1
+    int exec(bool transaction = false);
+    const std::vector<PgStatementResult> &results() const
+    {
+        return m_results;
+    }
+    const QString &lastError() const
+    {
+        return m_error;
+    }
+    std::size_t size() const
+    {
+        return m_statements.size();
+    }
+    void clear();
+
+  private:
+    struct Statement
+    {
+        QByteArray sql;
+        std::vector<QByteArray> params;
+        std::vector<bool> nulls;
+    };
+
+    bool send(const Statement &statement);
+    void read(PgStatementResult &result);
+    bool readSync();
+    bool leavePipeline();
+
+    QSqlDatabase m_db;
+    PGconn *m_conn = nullptr;
+    int m_window;
+    std::vector<Statement> m_statements;
+    std::vector<PgStatementResult> m_results;
+    QString m_error;
+};
+} // namespace _Kits
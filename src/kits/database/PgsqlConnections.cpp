@@ -1,6 +1,10 @@
 #include "PgsqlConnections.h"
+#include "PgPartitions.h"
+#include "PointCloudMigration.h"
+#include <QCryptographicHash>
 #include <QFile>
 #include <QRegularExpression>
+#include <QSqlDriver>
 
 namespace _Kits
 {
@@ -9,11 +13,25 @@ PgsqlConnections::PgsqlConnections(const QString &host,
                                    const QString &dbName,
                                    const QString &user,
                                    const QString &password,
-                                   int maxConnections)
-    : DatabaseConnections(host, port, dbName, user, password, maxConnections)
+                                   const DatabasePoolOptions &options)
+    : DatabaseConnections(host, port, dbName, user, password, options)
 {
 }
 
+PGconn *PgsqlConnections::nativeHandle(QSqlDatabase &db)
+{
+    if (!db.isValid() || !db.isOpen() || db.driver() == nullptr)
+    {
+        return nullptr;
+    }
+    QVariant handle = db.driver()->handle();
+    if (handle.isValid() && qstrcmp(handle.typeName(), "PGconn*") == 0)
+    {
+        return *static_cast<PGconn **>(handle.data());
+    }
+    return nullptr;
+}
+
 bool PgsqlConnections::checkAndCreateDatabase()
 {
     QString name = QString("pgsql_connection_init");
@@ -66,14 +84,6 @@ bool PgsqlConnections::checkAndCreateDatabase()
 
 bool PgsqlConnections::initializeDatabaseSchema()
 {
-    // 创建数据库连接
-    auto db = createConnection();
-    if (!db.isOpen() || !db.isValid())
-    {
-        qDebug() << "Failed to connect to target database for initialization.";
-        return false;
-    }
-
     // 打开 SQL 脚本文件
     QFile sqlFile("./config/pginit.sql");
     if (!sqlFile.open(QIODevice::ReadOnly | QIODevice::Text))
@@ -92,6 +102,34 @@ bool PgsqlConnections::initializeDatabaseSchema()
         return false;
     }
 
+    // 创建数据库连接
+    auto db = createConnection();
+    if (!db.isOpen() || !db.isValid())
+    {
+        qDebug() << "Failed to connect to target database for initialization.";
+        return false;
+    }
+
+    // 脚本未变化时跳过逐条执行，只做下面的增量维护
+    const auto checksum = QCryptographicHash::hash(script.toUtf8(), QCryptographicHash::Sha256).toHex();
+    if (schemaStamped(db, "pginit.sql", checksum))
+    {
+        qDebug() << "Database schema up to date, script skipped.";
+    }
+    else
+    {
+        runScript(db, script, checksum);
+    }
+    PointCloudMigration::instance().ensureColumns(db);
+    // 分区在写入开始前建好，之后由维护线程按周期补建和清理
+    PgPartitions::instance().maintain(db);
+    // 初始化线程随后退出，连接不能留给其他线程使用
+    closeConnection(std::move(db));
+    return true;
+}
+
+void PgsqlConnections::runScript(QSqlDatabase &db, QString script, const QByteArray &checksum)
+{
     // 使用正则表达式移除注释部分（单行和多行注释）
     QRegularExpression commentRegex(
         R"((--[^\n]*|/\*.*?\*/))",
@@ -101,6 +139,7 @@ bool PgsqlConnections::initializeDatabaseSchema()
     // 按分号分割 SQL 语句
     QStringList statements = script.split(";", Qt::SkipEmptyParts);
 
+    bool ok = true;
     for (const QString &statement : statements)
     {
         QString trimmedStatement = statement.trimmed();
@@ -111,40 +150,43 @@ bool PgsqlConnections::initializeDatabaseSchema()
         QSqlQuery initQuery(db);
         if (!initQuery.exec(trimmedStatement))
         {
+            ok = false;
             qDebug() << "Failed to execute statement:" << trimmedStatement
                      << "Error:" << initQuery.lastError().text();
         }
     }
 
-    qDebug() << "Database initialized with SQL script successfully.";
-    connectionPool_.push_back(std::move(db));
-    return true;
+    // 有语句失败时不记录版本戳，下次启动重新执行
+    if (ok)
+    {
+        stampSchema(db, "pginit.sql", checksum);
+        qDebug() << "Database initialized with SQL script successfully.";
+    }
 }
 
-// 初始化数据库连接池
+// 连接按使用线程按需创建，这里只校验能否建立连接
 bool PgsqlConnections::initializeConnectionPool()
 {
-    for (size_t i = 0; i < 5; i++)
+    auto connection = createConnection();
+    if (!connection.isOpen() || !connection.isValid())
     {
-        auto connection = createConnection();
-        if (!connection.isOpen() || !connection.isValid())
-        {
-            qDebug() << "Failed to create database connection for pool.";
-            return false;
-        }
-        connectionPool_.push_back(std::move(connection));
+        qDebug() << "Failed to create database connection for pool.";
+        return false;
     }
+    closeConnection(std::move(connection));
+    PgPartitions::instance().start();
+    PointCloudMigration::instance().start();
 
     qDebug() << "Database connection pool initialized successfully.";
     return true;
 }
+
 QSqlDatabase PgsqlConnections::createConnection()
 {
 
     QString name = QString("pgsql_connection_%1").arg(count_++);
 
     auto db = QSqlDatabase::addDatabase("QPSQL", name);
-    m_poolNames.push_back(name);
     db.setHostName(host_);
     db.setPort(port_);
     db.setDatabaseName(dbName_);
@@ -158,7 +200,7 @@ QSqlDatabase PgsqlConnections::createConnection()
         return {};
     }
 
-    qDebug() << "create sql connection size=" << count_;
+    qDebug() << "create sql connection size=" << count_.load();
     return db;
 }
 } // namespace _Kits
\ No newline at end of file
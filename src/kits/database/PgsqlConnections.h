@@ -1,6 +1,9 @@
 #pragma once
 #include "DatabaseConnections.h"
 #include <QSqlDatabase>
+
+typedef struct pg_conn PGconn;
+
 namespace _Kits
 {
 class PgsqlConnections : public DatabaseConnections
@@ -12,9 +15,12 @@ class PgsqlConnections : public DatabaseConnections
                               const QString &dbName,
                               const QString &user,
                               const QString &password,
-                              int maxConnections = 5);
+                              const DatabasePoolOptions &options = {});
     virtual ~PgsqlConnections() = default;
 
+    /// @brief 取出 QPSQL 连接底层的 libpq 句柄，非 PostgreSQL 连接返回 nullptr
+    static PGconn *nativeHandle(QSqlDatabase &db);
+
   public:
     virtual bool checkAndCreateDatabase() override;
     virtual bool initializeDatabaseSchema() override;
@@ -22,5 +28,8 @@ class PgsqlConnections : public DatabaseConnections
 
   protected:
     virtual QSqlDatabase createConnection() override;
+
+  private:
+    void runScript(QSqlDatabase &db, QString script, const QByteArray &checksum);
 };
 } // namespace _Kits
\ No newline at end of file
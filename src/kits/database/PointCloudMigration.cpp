@@ -0,0 +1,171 @@
+#include "PointCloudMigration.h"
+#include "DatabaseManager.h"
+#include "QueryResultCache.h"
+#include "kits/orm/TableStructs.h"
+#include "kits/required/log/CRossLogger.h"
+#include "kits/serialization/PointCloudCodec.h"
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QSqlRecord>
+#include <QStringList>
+#include <QVariantList>
+#include <chrono>
+
+namespace _Kits
+{
+    namespace
+    {
+        constexpr int kBatchSize = 500;
+        constexpr int kPauseMs = 100; // 批间间隔，给业务写入让出锁和 IO
+
+        const QStringList &pointTables()
+        {
+            static const QStringList tables{radar_data::tableName(), radar_over_data::tableName()};
+            return tables;
+        }
+    } // namespace
+
+    PointCloudMigration &PointCloudMigration::instance()
+    {
+        static PointCloudMigration migration;
+        return migration;
+    }
+
+    PointCloudMigration::~PointCloudMigration()
+    {
+        stop();
+    }
+
+    bool PointCloudMigration::ensureColumns(QSqlDatabase &db)
+    {
+        const bool pgsql = db.driverName() == "QPSQL";
+        bool ok = true;
+        for (const auto &table : pointTables())
+        {
+            const auto record = db.record(table);
+            if (record.isEmpty() || record.contains("points_bin"))
+            {
+                continue;
+            }
+            QSqlQuery query(db);
+            if (!query.exec(QString("ALTER TABLE %1 ADD COLUMN points_bin %2").arg(table, pgsql ? "bytea" : "LONGBLOB")))
+            {
+                LogWarn("point cloud: add column to {} failed: {}", table.toStdString(), query.lastError().text().toStdString());
+                ok = false;
+                continue;
+            }
+            LogInfo("point cloud: added {}.points_bin", table.toStdString());
+        }
+        return ok;
+    }
+
+    int PointCloudMigration::migrateBatch(QSqlDatabase &db, const QString &table, int batchSize)
+    {
+        auto &lastId = m_lastId[table];
+        QSqlQuery select(db);
+        select.setForwardOnly(true);
+        select.prepare(QString("SELECT id, points FROM %1 WHERE id > ? AND points_bin IS NULL AND points IS NOT NULL AND points <> '' "
+                               "ORDER BY id LIMIT ?")
+                           .arg(table));
+        select.addBindValue(lastId);
+        select.addBindValue(batchSize);
+        if (!select.exec())
+        {
+            LogWarn("point cloud: scan {} failed: {}", table.toStdString(), select.lastError().text().toStdString());
+            return -1;
+        }
+
+        QVariantList ids;
+        QVariantList blobs;
+        int scanned = 0;
+        qint64 last = lastId;
+        std::vector<RadarPoint> points;
+        while (select.next())
+        {
+            ++scanned;
+            last = select.value(0).toLongLong();
+            if (!PointCloudCodec::fromJson(select.value(1).toString(), points))
+            {
+                LogWarn("point cloud: {} id {} is not a point list, kept as text", table.toStdString(), last);
+                continue;
+            }
+            ids << last;
+            blobs << PointCloudCodec::encode(points);
+        }
+        select.finish();
+        if (ids.isEmpty())
+        {
+            lastId = last;
+            return scanned;
+        }
+
+        // 同一事务内写二进制并清空旧文本，失败整批回滚，下次从原位置重试
+        db.transaction();
+        QSqlQuery update(db);
+        update.prepare(QString("UPDATE %1 SET points_bin = ?, points = NULL WHERE id = ?").arg(table));
+        update.addBindValue(blobs);
+        update.addBindValue(ids);
+        if (!update.execBatch() || !db.commit())
+        {
+            LogWarn("point cloud: update {} failed: {}", table.toStdString(), update.lastError().text().toStdString());
+            db.rollback();
+            return -1;
+        }
+        lastId = last;
+        QueryResultCache::instance().invalidate(table);
+        return scanned;
+    }
+
+    void PointCloudMigration::start()
+    {
+        if (m_running.exchange(true))
+        {
+            return;
+        }
+        m_worker = std::thread([this]() {
+            std::size_t processed = 0;
+            auto tables = pointTables();
+            while (m_running && !tables.isEmpty())
+            {
+                {
+                    DBConnectionGuard guard;
+                    if (!guard.get().isOpen())
+                    {
+                        break;
+                    }
+                    for (auto it = tables.begin(); it != tables.end();)
+                    {
+                        // 转换完或出错的表本次不再处理，出错的留到下次启动
+                        const int rows = migrateBatch(guard.get(), *it, kBatchSize);
+                        if (rows <= 0)
+                        {
+                            it = tables.erase(it);
+                            continue;
+                        }
+                        processed += rows;
+                        ++it;
+                    }
+                }
+                std::unique_lock locker(m_mutex);
+                m_cv.wait_for(locker, std::chrono::milliseconds(kPauseMs), [this] { return !m_running; });
+            }
+            if (processed > 0)
+            {
+                LogInfo("point cloud: processed {} legacy rows", processed);
+            }
+        });
+    }
+
+    void PointCloudMigration::stop()
+    {
+        if (!m_running.exchange(false))
+        {
+            return;
+        }
+        m_cv.notify_all();
+        if (m_worker.joinable())
+        {
+            m_worker.join();
+        }
+    }
+} // namespace _Kits
@@ -0,0 +1,45 @@
+#pragma once
+#include <QSqlDatabase>
+#include <QString>
+#include <atomic>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <thread>
+
+namespace _Kits
+{
+/**
+ * @brief 点云列迁移：radar_data / radar_over_data 的 points 由 JSON 文本改为 PointCloudCodec 编码的 points_bin。
+ *
+ * - 建库脚本执行后补 points_bin 列（PostgreSQL 为 bytea，MySQL 为 LONGBLOB），已存在则跳过；
+ * - 后台线程按 id 升序分批把旧行的 points 编码写入 points_bin 并清空 points，
+ *   每批一个事务，批间让出连接，全部转换完即退出；
+ * - 无法解析的旧行保留原文，不会重复尝试（进程重启后会再试一次）。
+ *
+ * 迁移期间读取方用 PointCloudCodec::load(points_bin, points, ...) 兼容两种格式。
+ */
+class PointCloudMigration
+{
+  public:
+    static PointCloudMigration &instance();
+    ~PointCloudMigration();
+
+    /// @brief 为点云表补 points_bin 列，返回是否全部成功
+    bool ensureColumns(QSqlDatabase &db);
+    /// @brief 转换一批旧行，返回本批处理的行数（含无法解析而跳过的行），失败返回 -1
+    int migrateBatch(QSqlDatabase &db, const QString &table, int batchSize);
+    /// @brief 启动后台迁移线程（连接取自连接池）
+    void start();
+    void stop();
+
+  private:
+    PointCloudMigration() = default;
+
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    std::atomic<bool> m_running{false};
+    std::thread m_worker;
+    std::map<QString, qint64> m_lastId; // 各表已处理到的 id，仅迁移线程访问
+};
+} // namespace _Kits
@@ -0,0 +1,147 @@
+#include "PreparedStatementCache.h"
+#include "kits/required/config/ConfigService.h"
+#include <QSqlError>
+#include <algorithm>
+
+namespace _Kits
+{
+    PreparedStatementCache::Lease::Lease(Lease &&other) noexcept
+        : m_query(other.m_query), m_sql(other.m_sql), m_inUse(other.m_inUse), m_owned(std::move(other.m_owned))
+    {
+        other.m_query = nullptr;
+        other.m_sql = nullptr;
+        other.m_inUse = nullptr;
+    }
+
+    PreparedStatementCache::Lease &PreparedStatementCache::Lease::operator=(Lease &&other) noexcept
+    {
+        if (this != &other)
+        {
+            release();
+            m_query = other.m_query;
+            m_sql = other.m_sql;
+            m_inUse = other.m_inUse;
+            m_owned = std::move(other.m_owned);
+            other.m_query = nullptr;
+            other.m_sql = nullptr;
+            other.m_inUse = nullptr;
+        }
+        return *this;
+    }
+
+    PreparedStatementCache::Lease::~Lease()
+    {
+        release();
+    }
+
+    void PreparedStatementCache::Lease::bind(Entry &entry)
+    {
+        entry.inUse = true;
+        m_query = &entry.query;
+        m_sql = &entry.sql;
+        m_inUse = &entry.inUse;
+    }
+
+    void PreparedStatementCache::Lease::release()
+    {
+        if (m_inUse != nullptr)
+        {
+            // 释放结果集，保留服务端的预编译语句
+            m_query->finish();
+            *m_inUse = false;
+        }
+        m_query = nullptr;
+        m_sql = nullptr;
+        m_inUse = nullptr;
+        m_owned.reset();
+    }
+
+    PreparedStatementCache::PreparedStatementCache()
+        : m_capacity(static_cast<std::size_t>(
+              std::max(ConfigService::instance().snapshot()->database.statementCacheSize, 0)))
+    {
+    }
+
+    PreparedStatementCache &PreparedStatementCache::local()
+    {
+        thread_local PreparedStatementCache cache;
+        return cache;
+    }
+
+    PreparedCacheStats PreparedStatementCache::stats()
+    {
+        return {s_hits.load(), s_misses.load(), s_evictions.load(), s_bypasses.load()};
+    }
+
+    PreparedStatementCache::Lease PreparedStatementCache::acquire(QSqlDatabase &db,
+                                                                  const QString &key,
+                                                                  const std::function<QString()> &build,
+                                                                  QString &error)
+    {
+        Lease lease;
+        auto connection = m_connections.find(db.connectionName());
+        if (connection != m_connections.end())
+        {
+            auto &cache = connection->second;
+            auto found = cache.index.find(key);
+            if (found != cache.index.end() && !found->second->inUse)
+            {
+                ++s_hits;
+                cache.entries.splice(cache.entries.begin(), cache.entries, found->second);
+                lease.bind(cache.entries.front());
+                return lease;
+            }
+        }
+        else
+        {
+            // 新连接加入时顺带清理已被其他线程回收的连接留下的缓存
+            for (auto it = m_connections.begin(); it != m_connections.end();)
+            {
+                it = QSqlDatabase::contains(it->first) ? std::next(it) : m_connections.erase(it);
+            }
+            connection = m_connections.emplace(db.connectionName(), ConnectionCache{}).first;
+        }
+
+        auto &cache = connection->second;
+        QString sql = build();
+        QSqlQuery query(db);
+        // 缓存语句只按顺序读取：QPSQL 以单行模式、QMYSQL 以非缓冲方式取结果，不在客户端缓存整个结果集
+        query.setForwardOnly(true);
+        if (!query.prepare(sql))
+        {
+            error = query.lastError().text();
+            return lease;
+        }
+        // 同形状语句正在使用（嵌套查询）或未启用缓存：使用临时语句
+        if (cache.index.count(key) != 0 || m_capacity == 0)
+        {
+            ++s_bypasses;
+            lease.m_owned = std::make_unique<std::pair<QString, QSqlQuery>>(std::move(sql), std::move(query));
+            lease.m_query = &lease.m_owned->second;
+            lease.m_sql = &lease.m_owned->first;
+            return lease;
+        }
+
+        ++s_misses;
+        cache.entries.push_front(Entry{key, std::move(sql), std::move(query), false});
+        cache.index[key] = cache.entries.begin();
+        // 超出上限时从尾部淘汰未在使用的语句
+        for (auto it = cache.entries.end(); cache.entries.size() > m_capacity && it != cache.entries.begin();)
+        {
+            --it;
+            if (!it->inUse && it != cache.entries.begin())
+            {
+                cache.index.erase(it->key);
+                it = cache.entries.erase(it);
+                ++s_evictions;
+            }
+        }
+        lease.bind(cache.entries.front());
+        return lease;
+    }
+
+    void PreparedStatementCache::drop(const QString &connectionName)
+    {
+        m_connections.erase(connectionName);
+    }
+} // namespace _Kits
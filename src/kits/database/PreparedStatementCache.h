@@ -0,0 +1,104 @@
+#pragma once
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QString>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <unordered_map>
+
+namespace _Kits
+{
+struct PreparedCacheStats
+{
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t evictions = 0;
+    uint64_t bypasses = 0; // 同一语句正被使用，临时新建未缓存的语句
+};
+
+/**
+ * @brief 按连接缓存已 prepare 的 QSqlQuery，键为查询构造器给出的语句形状。
+ *
+ * 命中时跳过 SQL 拼接与 prepare（QPSQL 下即服务端解析），只重新绑定参数。
+ * 语句均为 forward-only，结果只能顺序读取一遍。
+ * 连接只在创建它的线程使用，缓存按线程保存，无需加锁；每个连接按 LRU 保留
+ * database.statement_cache_size 条语句。连接关闭前须调用 drop()。
+ */
+class PreparedStatementCache
+{
+  private:
+    struct Entry
+    {
+        QString key;
+        QString sql;
+        QSqlQuery query;
+        bool inUse = false;
+    };
+
+  public:
+    class Lease
+    {
+      public:
+        Lease() = default;
+        Lease(Lease &&other) noexcept;
+        Lease &operator=(Lease &&other) noexcept;
+        Lease(const Lease &) = delete;
+        Lease &operator=(const Lease &) = delete;
+        ~Lease();
+
+        QSqlQuery *query() const
+        {
+            return m_query;
+        }
+        const QString &sql() const
+        {
+            return *m_sql;
+        }
+        explicit operator bool() const
+        {
+            return m_query != nullptr;
+        }
+
+      private:
+        friend class PreparedStatementCache;
+        void bind(Entry &entry);
+        void release();
+
+        QSqlQuery *m_query = nullptr;
+        const QString *m_sql = nullptr;
+        bool *m_inUse = nullptr;
+        std::unique_ptr<std::pair<QString, QSqlQuery>> m_owned; // 未进入缓存的临时语句
+    };
+
+    static PreparedStatementCache &local();
+    static PreparedCacheStats stats();
+
+    /**
+     * @brief 取出形状为 key 的预编译语句，未命中时调用 build 生成 SQL 并 prepare。
+     * @return prepare 失败时返回空 Lease，error 为失败原因
+     */
+    Lease acquire(QSqlDatabase &db, const QString &key, const std::function<QString()> &build, QString &error);
+    /// @brief 连接关闭前丢弃其全部缓存语句
+    void drop(const QString &connectionName);
+
+  private:
+    struct ConnectionCache
+    {
+        std::list<Entry> entries; // 头部为最近使用
+        std::unordered_map<QString, std::list<Entry>::iterator> index;
+    };
+
+    PreparedStatementCache();
+
+    std::size_t m_capacity;
+    std::unordered_map<QString, ConnectionCache> m_connections;
+
+    inline static std::atomic<uint64_t> s_hits{0};
+    inline static std::atomic<uint64_t> s_misses{0};
+    inline static std::atomic<uint64_t> s_evictions{0};
+    inline static std::atomic<uint64_t> s_bypasses{0};
+};
+} // namespace _Kits
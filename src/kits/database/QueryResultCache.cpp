@@ -0,0 +1,197 @@
+#include "QueryResultCache.h"
+#include "kits/required/config/ConfigService.h"
+#include <QStringList>
+
+namespace _Kits
+{
+    QueryResultCache &QueryResultCache::instance()
+    {
+        static QueryResultCache cache;
+        return cache;
+    }
+
+    std::shared_ptr<const void> QueryResultCache::findRaw(const QByteArray &key)
+    {
+        std::lock_guard locker(m_mutex);
+        auto found = m_index.find(key);
+        if (found == m_index.end())
+        {
+            ++m_stats.misses;
+            return {};
+        }
+        if (Clock::now() >= found->second->expires)
+        {
+            eraseLocked(found->second);
+            ++m_stats.evictions;
+            ++m_stats.misses;
+            return {};
+        }
+        ++m_stats.hits;
+        m_entries.splice(m_entries.begin(), m_entries, found->second);
+        return m_entries.front().rows;
+    }
+
+    void QueryResultCache::storeRaw(const QByteArray &key,
+                                    const QString &table,
+                                    uint64_t generation,
+                                    std::shared_ptr<const void> rows,
+                                    std::size_t bytes,
+                                    int ttlMs)
+    {
+        const auto &config = ConfigService::instance().snapshot()->database;
+        const auto budget = static_cast<std::size_t>(std::max(config.resultCacheMb, 0)) * 1024 * 1024;
+        if (ttlMs <= 0)
+        {
+            ttlMs = config.resultCacheTtlMs;
+        }
+        if (bytes > budget || ttlMs <= 0)
+        {
+            return;
+        }
+
+        std::lock_guard locker(m_mutex);
+        // 查询期间表被写入，结果可能已过时
+        if (generationLocked(table) != generation)
+        {
+            return;
+        }
+        auto found = m_index.find(key);
+        if (found != m_index.end())
+        {
+            eraseLocked(found->second);
+        }
+        m_entries.push_front(Entry{key, table, std::move(rows), bytes, Clock::now() + std::chrono::milliseconds(ttlMs)});
+        m_index[key] = m_entries.begin();
+        m_stats.bytes += bytes;
+        while (m_stats.bytes > budget && !m_entries.empty())
+        {
+            eraseLocked(std::prev(m_entries.end()));
+            ++m_stats.evictions;
+        }
+    }
+
+    void QueryResultCache::eraseLocked(std::list<Entry>::iterator it)
+    {
+        m_stats.bytes -= it->bytes;
+        m_index.erase(it->key);
+        m_entries.erase(it);
+    }
+
+    uint64_t QueryResultCache::generationLocked(const QString &table) const
+    {
+        auto found = m_generations.find(table);
+        return m_globalGeneration + (found == m_generations.end() ? 0 : found->second);
+    }
+
+    uint64_t QueryResultCache::generation(const QString &table)
+    {
+        std::lock_guard locker(m_mutex);
+        return generationLocked(table);
+    }
+
+    void QueryResultCache::invalidate(const QString &table)
+    {
+        std::lock_guard locker(m_mutex);
+        ++m_generations[table];
+        for (auto it = m_entries.begin(); it != m_entries.end();)
+        {
+            auto current = it++;
+            if (current->table == table)
+            {
+                eraseLocked(current);
+                ++m_stats.invalidations;
+            }
+        }
+    }
+
+    void QueryResultCache::invalidateAll()
+    {
+        std::lock_guard locker(m_mutex);
+        ++m_globalGeneration;
+        m_stats.invalidations += m_entries.size();
+        m_entries.clear();
+        m_index.clear();
+        m_stats.bytes = 0;
+    }
+
+    void QueryResultCache::invalidateForSql(const QString &sql)
+    {
+        auto table = writeTarget(sql);
+        if (table.isEmpty())
+        {
+            return;
+        }
+        if (table == QLatin1String("*"))
+        {
+            invalidateAll();
+        }
+        else
+        {
+            invalidate(table);
+        }
+    }
+
+    QString QueryResultCache::writeTarget(const QString &sql)
+    {
+        const auto words = sql.simplified().split(' ', Qt::SkipEmptyParts);
+        if (words.isEmpty())
+        {
+            return {};
+        }
+        const auto verb = words.front().toUpper();
+        if (verb == QLatin1String("SELECT") || verb == QLatin1String("SHOW") || verb == QLatin1String("EXPLAIN") ||
+            verb == QLatin1String("BEGIN") || verb == QLatin1String("COMMIT") || verb == QLatin1String("ROLLBACK") ||
+            verb == QLatin1String("SET"))
+        {
+            return {};
+        }
+        // 目标表出现在这些关键字之后
+        qsizetype pos = -1;
+        for (qsizetype i = 1; i < words.size() && pos < 0; ++i)
+        {
+            const auto word = words[i].toUpper();
+            if ((verb == QLatin1String("INSERT") && word == QLatin1String("INTO")) ||
+                (verb == QLatin1String("DELETE") && word == QLatin1String("FROM")) ||
+                ((verb == QLatin1String("ALTER") || verb == QLatin1String("DROP")) && word == QLatin1String("TABLE")))
+            {
+                pos = i + 1;
+            }
+        }
+        if (verb == QLatin1String("UPDATE") || verb == QLatin1String("COPY"))
+        {
+            pos = 1;
+        }
+        else if (verb == QLatin1String("TRUNCATE"))
+        {
+            pos = words.size() > 1 && words[1].toUpper() == QLatin1String("TABLE") ? 2 : 1;
+        }
+        if (pos < 0 || pos >= words.size())
+        {
+            return QStringLiteral("*");
+        }
+        auto name = words[pos];
+        for (const auto &skip : {QLatin1String("ONLY"), QLatin1String("IF")})
+        {
+            if (name.toUpper() == skip && pos + 1 < words.size())
+            {
+                name = words[++pos];
+                if (skip == QLatin1String("IF") && pos + 1 < words.size())
+                {
+                    name = words[++pos]; // IF EXISTS
+                }
+            }
+        }
+        name = name.section('(', 0, 0).section(';', 0, 0);
+        name = name.section('.', -1); // 去掉 schema
+        name.remove('"');
+        return name.isEmpty() ? QStringLiteral("*") : name.toLower();
+    }
+
+    QueryCacheStats QueryResultCache::stats()
+    {
+        std::lock_guard locker(m_mutex);
+        auto stats = m_stats;
+        stats.entries = m_entries.size();
+        return stats;
+    }
+} // namespace _Kits
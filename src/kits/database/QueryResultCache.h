@@ -0,0 +1,128 @@
+#pragma once
+#include "kits/orm/OrmMapperImpl.h"
+#include <QByteArray>
+#include <QString>
+#include <chrono>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace _Kits
+{
+struct QueryCacheStats
+{
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t evictions = 0;     // 超出内存预算或过期被淘汰
+    uint64_t invalidations = 0; // 因写入对应表被清除
+    std::size_t entries = 0;
+    std::size_t bytes = 0; // 估算的结果集内存占用
+};
+
+/**
+ * @brief 进程内查询结果缓存，用于很少变化的参考表（线路、任务信息等）。
+ *
+ * 键为查询形状加绑定参数，按估算内存（database.result_cache.memory_mb）做 LRU 淘汰，
+ * 条目超过 TTL（database.result_cache.ttl_ms）后失效。经 SqlInsert、SqlCopy、
+ * CppBatis、PgPipeline 写入某张表时，该表的缓存全部清除。
+ * 查询开始前记下表的版本，期间表被写入则结果不入缓存，避免缓存旧数据。
+ *
+ * 通过 SqlSelect::cached() 按查询启用：
+ * @code
+ * SqlSelect<line_data> select;
+ * select.where("line_name", OperatorComparison::Equal, name).cached();
+ * auto rows = select.exec() ? select.getResults() : std::vector<line_data>{};
+ * @endcode
+ */
+class QueryResultCache
+{
+  public:
+    static QueryResultCache &instance();
+
+    template <typename T>
+    std::shared_ptr<const std::vector<T>> find(const QByteArray &key)
+    {
+        return std::static_pointer_cast<const std::vector<T>>(findRaw(key));
+    }
+
+    /// @brief generation 为查询前 generation(table) 的返回值；ttlMs <= 0 使用配置的默认值
+    template <typename T>
+    std::shared_ptr<const std::vector<T>> store(const QByteArray &key,
+                                                const QString &table,
+                                                uint64_t generation,
+                                                std::vector<T> &&rows,
+                                                int ttlMs = 0)
+    {
+        auto bytes = estimateBytes(rows);
+        auto shared = std::make_shared<const std::vector<T>>(std::move(rows));
+        storeRaw(key, table, generation, shared, bytes, ttlMs);
+        return shared;
+    }
+
+    /// @brief 表的当前版本，每次写入该表后递增
+    uint64_t generation(const QString &table);
+    void invalidate(const QString &table);
+    void invalidateAll();
+    /// @brief 按写语句的目标表清除缓存，无法识别目标表的写语句清除全部缓存
+    void invalidateForSql(const QString &sql);
+    /// @brief 提取写语句（INSERT/UPDATE/DELETE/TRUNCATE/COPY/DDL）的目标表；只读语句返回空，无法识别返回 "*"
+    static QString writeTarget(const QString &sql);
+
+    QueryCacheStats stats();
+
+  private:
+    using Clock = std::chrono::steady_clock;
+    struct Entry
+    {
+        QByteArray key;
+        QString table;
+        std::shared_ptr<const void> rows;
+        std::size_t bytes;
+        Clock::time_point expires;
+    };
+
+    QueryResultCache() = default;
+
+    std::shared_ptr<const void> findRaw(const QByteArray &key);
+    void storeRaw(const QByteArray &key,
+                  const QString &table,
+                  uint64_t generation,
+                  std::shared_ptr<const void> rows,
+                  std::size_t bytes,
+                  int ttlMs);
+    void eraseLocked(std::list<Entry>::iterator it);
+    uint64_t generationLocked(const QString &table) const;
+
+    // 估算：对象本身加字符串与二进制内容，只在未命中入缓存时计算一次
+    template <typename T>
+    static std::size_t estimateBytes(const std::vector<T> &rows)
+    {
+        std::size_t bytes = sizeof(std::vector<T>) + rows.capacity() * sizeof(T);
+        for (const auto &row : rows)
+        {
+            for (const auto &value : OrmMapper<T>::toRow(row, QDateTime()))
+            {
+                if (value.typeId() == QMetaType::QString)
+                {
+                    bytes += static_cast<std::size_t>(value.toString().size()) * sizeof(QChar);
+                }
+                else if (value.typeId() == QMetaType::QByteArray)
+                {
+                    bytes += static_cast<std::size_t>(value.toByteArray().size());
+                }
+            }
+        }
+        return bytes;
+    }
+
+    std::mutex m_mutex;
+    std::list<Entry> m_entries; // 头部为最近使用
+    std::unordered_map<QByteArray, std::list<Entry>::iterator> m_index;
+    std::unordered_map<QString, uint64_t> m_generations;
+    uint64_t m_globalGeneration = 0;
+    QueryCacheStats m_stats;
+};
+} // namespace _Kits
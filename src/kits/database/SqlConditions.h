@@ -0,0 +1,240 @@
+#pragma once
+#include "SqlTypes.h"
+#include <QDataStream>
+#include <QDateTime>
+#include <QList>
+#include <QSqlQuery>
+#include <QString>
+#include <QStringList>
+#include <QVariant>
+#include <QVariantList>
+#include <map>
+
+namespace _Kits
+{
+    /**
+     * @brief WHERE 条件列表，供 SqlSelect / SqlUpdate 共用。
+     *
+     * 参数一律以位置占位符绑定；arrayBinding 为 true（PostgreSQL）时 IN 以单个数组参数绑定，
+     * 集合大小不影响语句形状。数组元素类型取自列类型（setArrayTypes），须在生成语句前设置。
+     */
+    class SqlConditions
+    {
+      public:
+        void add(const QString &field, OperatorComparison op, const QVariant &value, OperatorLogical logicOperator = OperatorLogical::And)
+        {
+            // 第一个条件前没有逻辑连接符
+            m_conditions.append(Condition(field, op, value, m_conditions.isEmpty() ? OperatorLogical::And : logicOperator));
+        }
+
+        bool isEmpty() const
+        {
+            return m_conditions.isEmpty();
+        }
+
+        // IN 条件涉及的列
+        QStringList arrayFields() const
+        {
+            QStringList fields;
+            for (const auto &condition : m_conditions)
+            {
+                if (condition.op == OperatorComparison::In && !fields.contains(condition.field))
+                {
+                    fields << condition.field;
+                }
+            }
+            return fields;
+        }
+
+        // 按列类型（format_type 文本）设置 IN 数组的元素类型；types 中没有的列按值推断
+        void setArrayTypes(const std::map<QString, QString> &types)
+        {
+            for (auto &condition : m_conditions)
+            {
+                if (condition.op == OperatorComparison::In)
+                {
+                    auto it = types.find(condition.field);
+                    condition.arrayType = it != types.end() ? it->second : QString();
+                }
+            }
+        }
+
+        // 语句形状中与条件有关的部分，不含参数值
+        void appendShape(QString &key, bool arrayBinding) const
+        {
+            for (const auto &condition : m_conditions)
+            {
+                key.append('|').append(condition.field);
+                key.append(QChar('0' + static_cast<int>(condition.op)));
+                key.append(QChar('0' + static_cast<int>(condition.logicOperator)));
+                if (condition.op == OperatorComparison::In)
+                {
+                    const auto values = condition.value.toList();
+                    key.append(arrayBinding ? arrayType(condition) : QString::number(values.size()));
+                }
+            }
+        }
+
+        // 全部参数值，用于结果缓存键
+        void appendValues(QDataStream &stream) const
+        {
+            for (const auto &condition : m_conditions)
+            {
+                stream << condition.value;
+            }
+        }
+
+        QString clause(bool arrayBinding) const
+        {
+            QStringList clauses;
+            for (const auto &condition : m_conditions)
+            {
+                QString clause = buildCondition(condition, arrayBinding);
+                if (!clauses.isEmpty())
+                {
+                    clause = SqlOperators::logicalOperatorMap.at(condition.logicOperator) + " " + clause;
+                }
+                clauses.append(clause);
+            }
+            return clauses.join(' ');
+        }
+
+        // 按在 SQL 中出现的顺序绑定，pos 为起始位置并随之递增
+        void bind(QSqlQuery &query, int &pos, bool arrayBinding) const
+        {
+            for (const auto &condition : m_conditions)
+            {
+                switch (condition.op)
+                {
+                case OperatorComparison::Between:
+                {
+                    const auto range = condition.value.toList();
+                    query.bindValue(pos++, range.value(0));
+                    query.bindValue(pos++, range.value(1));
+                    break;
+                }
+                case OperatorComparison::In:
+                    if (arrayBinding)
+                    {
+                        query.bindValue(pos++, pgArrayLiteral(condition.value.toList()));
+                    }
+                    else
+                    {
+                        for (const auto &value : condition.value.toList())
+                        {
+                            query.bindValue(pos++, value);
+                        }
+                    }
+                    break;
+                default:
+                    query.bindValue(pos++, condition.value);
+                }
+            }
+        }
+
+        // 列类型未知时按首个元素推断数组元素类型；整数统一为 int8，与 int4 列比较时仍可走索引
+        static QString pgArrayType(const QVariantList &values)
+        {
+            if (values.isEmpty())
+            {
+                return QStringLiteral("text");
+            }
+            switch (values.front().typeId())
+            {
+            case QMetaType::Int:
+            case QMetaType::UInt:
+            case QMetaType::Short:
+            case QMetaType::UShort:
+            case QMetaType::Long:
+            case QMetaType::LongLong:
+            case QMetaType::ULongLong:
+                return QStringLiteral("int8");
+            case QMetaType::Float:
+            case QMetaType::Double:
+                return QStringLiteral("float8");
+            case QMetaType::Bool:
+                return QStringLiteral("bool");
+            case QMetaType::QDateTime:
+                return QStringLiteral("timestamp");
+            default:
+                return QStringLiteral("text");
+            }
+        }
+
+        // PostgreSQL 数组文本，如 {"1","2"}；元素一律加引号，内部的 \ 与 " 转义
+        static QString pgArrayLiteral(const QVariantList &values)
+        {
+            QString literal = QStringLiteral("{");
+            for (qsizetype i = 0; i < values.size(); ++i)
+            {
+                if (i > 0)
+                {
+                    literal.append(',');
+                }
+                const auto &value = values[i];
+                if (value.isNull())
+                {
+                    literal.append(QStringLiteral("NULL"));
+                    continue;
+                }
+                QString text = value.typeId() == QMetaType::QDateTime
+                                   ? value.toDateTime().toString(Qt::ISODateWithMs)
+                                   : value.toString();
+                text.replace('\\', QStringLiteral("\\\\")).replace('"', QStringLiteral("\\\""));
+                literal.append('"').append(text).append('"');
+            }
+            literal.append('}');
+            return literal;
+        }
+
+      private:
+        struct Condition
+        {
+            QString field;
+            OperatorComparison op;
+            QVariant value;
+            OperatorLogical logicOperator;
+            QString arrayType; // IN 数组元素类型，为空时按值推断
+
+            Condition(const QString &f, OperatorComparison o, const QVariant &v, OperatorLogical lo = OperatorLogical::And) : field(f), op(o), value(v), logicOperator(lo)
+            {
+            }
+        };
+
+        static QString arrayType(const Condition &condition)
+        {
+            return condition.arrayType.isEmpty() ? pgArrayType(condition.value.toList()) : condition.arrayType;
+        }
+
+        static QString buildCondition(const Condition &condition, bool arrayBinding)
+        {
+            switch (condition.op)
+            {
+            case OperatorComparison::Between:
+                return QString("%1 BETWEEN ? AND ?").arg(condition.field);
+            case OperatorComparison::In:
+            {
+                const auto values = condition.value.toList();
+                if (arrayBinding)
+                {
+                    return QString("%1 = ANY(CAST(? AS %2[]))").arg(condition.field, arrayType(condition));
+                }
+                if (values.isEmpty())
+                {
+                    return QStringLiteral("1 = 0");
+                }
+                QStringList placeholders;
+                for (qsizetype i = 0; i < values.size(); ++i)
+                {
+                    placeholders << QStringLiteral("?");
+                }
+                return QString("%1 IN (%2)").arg(condition.field, placeholders.join(", "));
+            }
+            default:
+                return QString("%1 %2 ?").arg(condition.field, SqlOperators::comparisonOperatorMap.at(condition.op));
+            }
+        }
+
+        QList<Condition> m_conditions;
+    };
+} // namespace _Kits
@@ -0,0 +1,92 @@
+#pragma once
+#include "PgBinaryCopy.h"
+#include "QueryResultCache.h"
+#include "SqlQuery.h"
+#include "kits/orm/OrmMapperImpl.h"
+#include <vector>
+
+namespace _Kits
+{
+/**
+ * @brief PostgreSQL 批量导入：以二进制 COPY 流式写入，适合上万行以上的批次。
+ *
+ * 列取自 OrmMapper<T>（不含自增 id），与 SqlInsert 写入的列一致。
+ * 非 PostgreSQL 连接或存在不支持的列类型时 exec() 返回 false，可改用 SqlInsert。
+ *
+ * @code
+ * SqlCopy<radar_data> copy;
+ * copy.copy(rows).exec();
+ * int n = copy.getNumAffected();
+ * @endcode
+ */
+template <typename T>
+class SqlCopy : public SqlQuery<T>
+{
+  public:
+    SqlCopy() = default;
+    SqlCopy(SqlCopy &&) = default;
+    SqlCopy &operator=(SqlCopy &&) = default;
+    virtual ~SqlCopy() = default;
+
+    template <typename Container>
+    SqlCopy &copy(const Container &objects)
+    {
+        m_rows.clear();
+        m_rows.reserve(objects.size());
+        m_columns = OrmMapper<T>::valueColumns();
+        const auto now = QDateTime::currentDateTime();
+        for (const auto &object : objects)
+        {
+            m_rows.push_back(OrmMapper<T>::toRow(object, now));
+        }
+        return *this;
+    }
+
+    virtual bool exec() override
+    {
+        this->m_success = false;
+        m_affected = 0;
+        if (m_rows.empty())
+        {
+            this->m_success = true;
+            return true;
+        }
+        PgBinaryCopy writer(this->database());
+        this->m_sql = QString("COPY %1 (%2)").arg(T::tableName(), m_columns.join(", "));
+        if (!writer.begin(T::tableName(), m_columns))
+        {
+            qDebug() << "COPY 启动失败: " << this->m_sql << writer.lastError();
+            return false;
+        }
+        for (const auto &row : m_rows)
+        {
+            if (!writer.addRow(row))
+            {
+                qDebug() << "COPY 编码失败: " << this->m_sql << writer.lastError();
+                writer.abort();
+                return false;
+            }
+        }
+        auto rows = writer.end();
+        if (rows < 0)
+        {
+            qDebug() << "COPY 执行失败: " << this->m_sql << writer.lastError();
+            return false;
+        }
+        m_affected = static_cast<int>(rows);
+        this->m_success = true;
+        QueryResultCache::instance().invalidate(T::tableName());
+        return true;
+    }
+
+    int getNumAffected() const
+    {
+        return m_affected;
+    }
+
+  private:
+    QStringList m_columns;
+    std::vector<std::vector<QVariant>> m_rows;
+    int m_affected = 0;
+};
+} // namespace _Kits
@@ -1,4 +1,5 @@
 #pragma once
+#include "QueryResultCache.h"
 #include "SqlQuery.h"
 #include "kits/orm/OrmMapperImpl.h"
 #include <QDebug>
@@ -7,7 +8,7 @@
 #include <QVariant>
 #include <QVariantList>
 #include <qsqlquery.h>
-#include <unordered_map>
+#include <vector>
 
 namespace _Kits
 {
@@ -17,6 +18,8 @@ namespace _Kits
     {
       public:
         SqlInsert() = default;
+        SqlInsert(SqlInsert &&) = default;
+        SqlInsert &operator=(SqlInsert &&) = default;
         virtual ~SqlInsert() = default;
         virtual bool exec() override
         {
@@ -43,15 +46,7 @@ namespace _Kits
         SqlInsert &insert(const U &object)
         {
             m_isBatch = false;
-            qDebug() << object.created_time;
-            auto map = OrmMapper<T>::toMap(object);
-            buildSqlStatement(map);
-            for (const auto &[key, value] : map)
-            {
-                qDebug() << value;
-                if (key != "id")
-                    m_singleValues[":" + key] = std::move(value);
-            }
+            m_singleValues = OrmMapper<T>::toRow(object);
             return *this;
         }
 
@@ -61,72 +56,80 @@ namespace _Kits
             if (objects.empty())
                 return *this;
             m_isBatch = true;
-            bool firstUse = true;
+            m_batchValues.assign(OrmMapper<T>::valueCount, {});
+            for (auto &column : m_batchValues)
+            {
+                column.reserve(objects.size());
+            }
+            // 同一批次共用一个写入时间
+            const auto now = QDateTime::currentDateTime();
             for (const auto &object : objects)
             {
-                auto objMap = OrmMapper<T>::toMap(object);
-                if (firstUse)
-                {
-                    firstUse = false;
-                    buildSqlStatement(objMap);
-                }
-                for (const auto &[key, value] : objMap)
-                {
-                    if (key != "id")
-                        m_batchValues[":" + key].append(std::move(value));
-                }
+                OrmMapper<T>::appendColumns(m_batchValues, object, now);
             }
             m_batchSize = objects.size();
             return *this;
         }
 
       protected:
-        void buildSqlStatement(const std::unordered_map<std::string, QVariant> &map)
+        // 同一张表的插入字段固定，语句形状只取决于表名；SQL 仅在缓存未命中时生成
+        static QString shapeKey()
+        {
+            return QStringLiteral("INSERT|") + T::tableName();
+        }
+
+        // 按位置绑定，列顺序取自 OrmMapper<T>::valueColumns()
+        static QString buildSqlStatement()
         {
-            QStringList fields, placeholders;
-            for (const auto &[key, _] : map)
+            const auto &fields = OrmMapper<T>::valueColumns();
+            QStringList placeholders;
+            for (qsizetype i = 0; i < fields.size(); ++i)
             {
-                if (key != "id")
-                {
-                    fields << QString::fromStdString(key);
-                    placeholders << ":" + QString::fromStdString(key);
-                }
+                placeholders << QStringLiteral("?");
             }
             // 不再使用 RETURNING id，影响批量性能
-            this->m_sql =
-                QString("INSERT INTO %1 (%2) VALUES (%3)").arg(T::tableName()).arg(fields.join(", ")).arg(placeholders.join(", "));
+            return QString("INSERT INTO %1 (%2) VALUES (%3)").arg(T::tableName()).arg(fields.join(", ")).arg(placeholders.join(", "));
         }
 
         bool execSingle()
         {
-            if (!this->m_query.prepare(this->m_sql))
+            if (!this->prepareCached(shapeKey(), &SqlInsert::buildSqlStatement))
             {
-                this->innerError();
                 return false;
             }
-            for (const auto &[key, value] : m_singleValues)
+            auto &query = this->activeQuery();
+            for (std::size_t i = 0; i < m_singleValues.size(); ++i)
             {
-                this->m_query.bindValue(QString::fromStdString(key), value);
+                query.bindValue(static_cast<int>(i), m_singleValues[i]);
             }
-            return this->m_query.exec();
+            this->recordFlight();
+            this->m_success = query.exec();
+            if (!this->m_success)
+            {
+                this->innerError();
+                return false;
+            }
+            QueryResultCache::instance().invalidate(T::tableName());
+            return true;
         }
 
         bool execBatch()
         {
-            if (!this->m_query.prepare(this->m_sql))
+            if (!this->prepareCached(shapeKey(), &SqlInsert::buildSqlStatement))
             {
-                this->innerError();
                 return false;
             }
-            for (const auto &[key, values] : m_batchValues)
+            auto &query = this->activeQuery();
+            for (std::size_t i = 0; i < m_batchValues.size(); ++i)
             {
-                this->m_query.bindValue(QString::fromStdString(key), values);
+                query.bindValue(static_cast<int>(i), m_batchValues[i]);
             }
 
-            auto &db = this->m_dbGuard.get();
+            auto &db = this->database();
 
+            this->recordFlight();
             db.transaction(); // 开始事务
-            this->m_success = this->m_query.execBatch();
+            this->m_success = query.execBatch();
             if (!this->m_success)
             {
                 this->innerError();
@@ -134,14 +137,15 @@ namespace _Kits
                 return false;
             }
             this->m_success = db.commit();
+            QueryResultCache::instance().invalidate(T::tableName());
             return this->m_success; // 成功提交
         }
 
       private:
         bool m_isBatch = false;
         int m_batchSize = 0;
-        std::unordered_map<std::string, QVariant> m_singleValues;
-        std::unordered_map<std::string, QVariantList> m_batchValues;
+        std::vector<QVariant> m_singleValues;      // 按 valueColumns() 顺序
+        std::vector<QVariantList> m_batchValues;   // 每列一个值列表
     };
 
 } // namespace _Kits
@@ -1,6 +1,16 @@
 #pragma once
 #include "DatabaseManager.h"
+#include "PreparedStatementCache.h"
+#include "kits/required/log/FlightRecorder.h"
+#include <QDebug>
+#include <QSqlError>
 #include <QSqlQuery>
+#include <QStringList>
+#include <algorithm>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
 
 namespace _Kits
 {
@@ -9,19 +19,130 @@ template <typename T>
 class SqlQuery
 {
   public:
-    SqlQuery() : m_query(m_dbGuard.get()) {};
+    SqlQuery() = default;
+    SqlQuery(SqlQuery &&) = default;
+    // 先释放缓存语句再归还连接，连接归还时可能被关闭
+    SqlQuery &operator=(SqlQuery &&other)
+    {
+        m_lease = std::move(other.m_lease);
+        m_query = std::move(other.m_query);
+        m_dbGuard = std::move(other.m_dbGuard);
+        m_sql = std::move(other.m_sql);
+        m_success = other.m_success;
+        return *this;
+    }
     virtual ~SqlQuery() {};
     virtual bool exec() = 0;
+    /// @brief exec() 失败后判断是否因数据库不可用（未取到连接、连接错误或连接已无法执行 SELECT 1）
+    bool connectionLost()
+    {
+        auto &db = database();
+        if (!db.isOpen() || activeQuery().lastError().type() == QSqlError::ConnectionError)
+        {
+            return true;
+        }
+        return !QSqlQuery(db).exec("SELECT 1");
+    }
 
   protected:
+    // 首次执行时才在当前线程获取连接，查询对象可以在其他线程构造后提交执行
+    QSqlDatabase &database()
+    {
+        if (!m_dbGuard)
+        {
+            m_dbGuard = std::make_unique<DBConnectionGuard>();
+        }
+        return m_dbGuard->get();
+    }
+    // 不经缓存的语句，用于一次性的 SQL
+    QSqlQuery &query()
+    {
+        if (!m_query.driver())
+        {
+            m_query = QSqlQuery(database());
+        }
+        return m_query;
+    }
+    // 按语句形状从当前连接的缓存中取已 prepare 的语句，命中时不调用 build
+    bool prepareCached(const QString &shapeKey, const std::function<QString()> &build)
+    {
+        m_lease = {};
+        QString error;
+        m_lease = PreparedStatementCache::local().acquire(database(), shapeKey, build, error);
+        if (!m_lease)
+        {
+            qDebug() << "SQL准备失败: " << shapeKey << error;
+            return false;
+        }
+        m_sql = m_lease.sql();
+        return true;
+    }
+    // 当前语句：prepareCached 成功后为缓存语句，否则为 query()
+    QSqlQuery &activeQuery()
+    {
+        return m_lease ? *m_lease.query() : m_query;
+    }
+    // 执行前记录到飞行记录器，崩溃分析时可还原最后执行的 SQL
+    void recordFlight() const
+    {
+        if (FlightRecorder::instance().isOpen())
+        {
+            flightEvent(FlightKind::database, m_sql.toStdString());
+        }
+    }
+    /**
+     * @brief 多行语句每条包含的行数：不超过剩余行数的最大 2 的幂，并受单条语句参数个数上限约束。
+     *
+     * 同一张表的多行语句因此最多有十余种形状，都能留在语句缓存中；1 万行约十条语句。
+     */
+    static std::size_t chunkRows(std::size_t remaining, std::size_t columns)
+    {
+        const std::size_t limit = std::min<std::size_t>(1024, 65535 / std::max<std::size_t>(columns, 1));
+        std::size_t rows = 1;
+        while (rows * 2 <= std::min(remaining, limit))
+        {
+            rows *= 2;
+        }
+        return rows;
+    }
+    // 表的列类型（format_type 文本），进程内缓存；缺少所需列时重新读取一次（如启动后新增的列）
+    static std::map<QString, QString> pgColumnTypes(QSqlDatabase &db, const QStringList &needed)
+    {
+        static std::mutex mutex;
+        static std::map<QString, QString> types;
+        std::lock_guard locker(mutex);
+        auto complete = [&needed]() {
+            return std::all_of(needed.begin(), needed.end(), [](const QString &column) { return types.count(column) > 0; });
+        };
+        if (!complete())
+        {
+            QSqlQuery query(db);
+            query.prepare("SELECT attname, format_type(atttypid, atttypmod) FROM pg_attribute "
+                          "WHERE attrelid = CAST(? AS regclass) AND attnum > 0 AND NOT attisdropped");
+            query.addBindValue(T::tableName());
+            if (!query.exec())
+            {
+                qDebug() << "读取列类型失败:" << T::tableName() << query.lastError().text();
+                return {};
+            }
+            types.clear();
+            while (query.next())
+            {
+                types[query.value(0).toString()] = query.value(1).toString();
+            }
+        }
+        return complete() ? types : std::map<QString, QString>{};
+    }
     void innerError()
     {
-        qDebug() << "SQL执行失败: " << m_sql << m_query.lastError().text();
+        qDebug() << "SQL执行失败: " << m_sql << activeQuery().lastError().text();
     }
     QString m_sql;
     bool m_success = false;
-    DBConnectionGuard m_dbGuard;
+    // 析构顺序依赖声明顺序：缓存语句、语句先于连接释放
+    std::unique_ptr<DBConnectionGuard> m_dbGuard;
     QSqlQuery m_query;
+    PreparedStatementCache::Lease m_lease;
 };
 
 } // namespace _Kits
@@ -1,18 +1,122 @@
 #pragma once
+#include "QueryResultCache.h"
+#include "SqlConditions.h"
 #include "SqlQuery.h"
 #include "SqlTypes.h"
 #include "kits/orm/OrmMapperImpl.h"
+#include <QDataStream>
+#include <QDateTime>
 #include <QDebug>
+#include <QVariantList>
+#include <iterator>
 #include <vector>
 
 namespace _Kits
 {
+    /**
+     * @brief 只进结果游标：逐行读取并转换，不保留已读过的行。
+     *
+     * 查询以 forward-only 方式执行，QPSQL 下使用单行模式、QMYSQL 下使用非缓冲读取，
+     * 客户端内存与结果集大小无关。游标依附于产生它的 SqlSelect，须在其生命周期内使用。
+     */
+    template <typename T>
+    class SqlCursor
+    {
+      public:
+        class iterator
+        {
+          public:
+            using iterator_category = std::input_iterator_tag;
+            using value_type = T;
+            using difference_type = std::ptrdiff_t;
+            using pointer = T *;
+            using reference = T &;
+
+            iterator() = default;
+            explicit iterator(SqlCursor *cursor) : m_cursor(cursor)
+            {
+                advance();
+            }
+            T &operator*()
+            {
+                return m_cursor->m_current;
+            }
+            T *operator->()
+            {
+                return &m_cursor->m_current;
+            }
+            iterator &operator++()
+            {
+                advance();
+                return *this;
+            }
+            bool operator==(const iterator &other) const
+            {
+                return m_cursor == other.m_cursor;
+            }
+            bool operator!=(const iterator &other) const
+            {
+                return m_cursor != other.m_cursor;
+            }
+
+          private:
+            void advance()
+            {
+                if (m_cursor && !m_cursor->next())
+                {
+                    m_cursor = nullptr;
+                }
+            }
+            SqlCursor *m_cursor = nullptr;
+        };
+
+        explicit SqlCursor(QSqlQuery *query) : m_query(query)
+        {
+            if (m_query)
+            {
+                m_columns = OrmMapper<T>::resolve(m_query->record());
+            }
+        }
+
+        iterator begin()
+        {
+            return iterator(m_query ? this : nullptr);
+        }
+        iterator end()
+        {
+            return {};
+        }
+        // 已读取的行数
+        qsizetype count() const
+        {
+            return m_count;
+        }
+
+      private:
+        bool next()
+        {
+            if (!m_query->next())
+            {
+                return false;
+            }
+            m_current = OrmMapper<T>::fromQuery(*m_query, m_columns);
+            ++m_count;
+            return true;
+        }
+
+        QSqlQuery *m_query = nullptr;
+        typename OrmMapper<T>::Columns m_columns{};
+        T m_current;
+        qsizetype m_count = 0;
+    };
 
     template <typename T>
     class SqlSelect : public SqlQuery<T>
     {
       public:
         SqlSelect() = default;
+        SqlSelect(SqlSelect &&) = default;
+        SqlSelect &operator=(SqlSelect &&) = default;
         ~SqlSelect() = default;
 
         // 设置要查询的字段列表
@@ -25,17 +129,34 @@ namespace _Kits
         // 添加查询条件
         SqlSelect<T> &where(const QString &field, OperatorComparison op, const QVariant &value, OperatorLogical logicOperator = OperatorLogical::And)
         {
-            if (m_conditions.isEmpty())
-            {
-                m_conditions.append(Condition(field, op, value));
-            }
-            else
-            {
-                m_conditions.append(Condition(field, op, value, logicOperator));
-            }
+            m_conditions.add(field, op, value, logicOperator);
             return *this;
         }
 
+        // 批量按键查询，一次往返取回整个集合
+        SqlSelect<T> &whereIn(const QString &field, const QVariantList &values, OperatorLogical logicOperator = OperatorLogical::And)
+        {
+            return where(field, OperatorComparison::In, values, logicOperator);
+        }
+
+        // 闭区间 [low, high]
+        SqlSelect<T> &whereBetween(const QString &field, const QVariant &low, const QVariant &high, OperatorLogical logicOperator = OperatorLogical::And)
+        {
+            return where(field, OperatorComparison::Between, QVariantList{low, high}, logicOperator);
+        }
+
+        /**
+         * @brief 时间范围 [from, to)，分区表上只扫描覆盖该范围的分区。
+         *
+         * 边界以参数绑定，裁剪发生在执行器启动时而不是规划时：未覆盖的分区不会被扫描，
+         * 但 EXPLAIN 中仍会列出（标注 Subplans Removed）。
+         */
+        SqlSelect<T> &during(const QDateTime &from, const QDateTime &to, const QString &column = QStringLiteral("created_time"))
+        {
+            where(column, OperatorComparison::GreaterEqual, from);
+            return where(column, OperatorComparison::LessThan, to);
+        }
+
         // 添加排序规则
         SqlSelect<T> &orderBy(const QString &field, bool ascending = true)
         {
@@ -50,7 +171,7 @@ namespace _Kits
             return *this;
         }
 
-        // 设置分页参数
+        // 设置分页参数（LIMIT/OFFSET，越往后越慢；大表顺序扫描请用 after + limit）
         SqlSelect<T> &paginate(int page, int pageSize)
         {
             m_page = page;
@@ -58,102 +179,246 @@ namespace _Kits
             return *this;
         }
 
+        // 限制返回行数
+        SqlSelect<T> &limit(int count)
+        {
+            m_limit = count;
+            return *this;
+        }
+
+        /**
+         * @brief 键集分页：只取 keyField 大于 lastKey 的行，并按 keyField 升序排列。
+         *
+         * 每页都走索引定位，与页码无关。下一页以本页最后一行的键继续：
+         * @code
+         * qint64 last = 0;
+         * for (;;)
+         * {
+         *     SqlSelect<radar_data> select;
+         *     select.after(last).limit(1000);
+         *     auto rows = select.exec() ? select.getResults() : std::vector<radar_data>{};
+         *     if (rows.empty())
+         *         break;
+         *     last = rows.back().id;
+         * }
+         * @endcode
+         */
+        SqlSelect<T> &after(const QVariant &lastKey, const QString &keyField = QStringLiteral("id"))
+        {
+            m_afterField = keyField;
+            m_afterValue = lastKey;
+            return *this;
+        }
+
+        /**
+         * @brief 启用结果缓存（见 QueryResultCache），适合很少变化的参考表。
+         * @param ttlMs 缓存有效期，<= 0 使用 database.result_cache.ttl_ms
+         */
+        SqlSelect<T> &cached(int ttlMs = 0)
+        {
+            m_cache = true;
+            m_cacheTtlMs = ttlMs;
+            return *this;
+        }
+
         // 执行查询并获取结果集
+        // 启用缓存时命中则不访问数据库
         virtual bool exec() override
         {
-            this->m_sql = buildSelectStatement();
-            if (!this->m_query.prepare(this->m_sql))
+            m_cachedRows.reset();
+            if (!m_cache)
             {
-                this->innerError();
-                return false;
+                return execQuery();
             }
-
-            for (const auto &condition : m_conditions)
+            auto &cache = QueryResultCache::instance();
+            const auto key = cacheKey();
+            m_cachedRows = cache.find<T>(key);
+            if (m_cachedRows)
             {
-                this->m_query.bindValue(":" + condition.field, condition.value);
+                this->m_success = true;
+                return true;
             }
-
-            if (!this->m_query.exec())
+            const auto generation = cache.generation(T::tableName());
+            if (!execQuery())
             {
-                this->innerError();
                 return false;
             }
-            this->m_success = true;
+            m_cachedRows = cache.store(key, T::tableName(), generation, readAll(), m_cacheTtlMs);
             return true;
         }
+
         std::vector<T> getResults()
         {
             if (!this->m_success)
                 return {};
-            std::vector<T> results;
-            while (this->m_query.next())
+            if (m_cachedRows)
+                return *m_cachedRows;
+            return readAll();
+        }
+
+        /**
+         * @brief 以只进游标逐行读取结果，未执行时先执行。不经过结果缓存。
+         * @code
+         * SqlSelect<radar_data> select;
+         * select.where("task_id", OperatorComparison::Equal, taskId);
+         * for (auto &row : select.stream())
+         * {
+         *     process(row);
+         * }
+         * @endcode
+         */
+        SqlCursor<T> stream()
+        {
+            if ((!this->m_success || m_cachedRows) && !execQuery())
             {
-                auto record = this->m_query.record();
-                auto obj = OrmMapper<T>::fromRecord(record);
-                results.push_back(std::move(obj));
+                return SqlCursor<T>(nullptr);
             }
-            return results;
+            m_cachedRows.reset();
+            return SqlCursor<T>(&this->activeQuery());
         }
 
       private:
-        struct Condition
+        bool execQuery()
         {
-            QString field;
-            OperatorComparison op;
-            QVariant value;
-            OperatorLogical logicOperator;
+            // PostgreSQL 的 IN 以数组参数绑定，集合大小不影响语句形状
+            m_arrayBinding = this->database().driverName() == QLatin1String("QPSQL");
+            if (m_arrayBinding)
+            {
+                m_conditions.setArrayTypes(SqlQuery<T>::pgColumnTypes(this->database(), m_conditions.arrayFields()));
+            }
+            // 同形状的查询复用连接上已 prepare 的语句，只重新绑定参数
+            if (!this->prepareCached(shapeKey(m_arrayBinding), [this] { return buildSelectStatement(); }))
+            {
+                return false;
+            }
 
-            Condition(const QString &f, OperatorComparison o, const QVariant &v, OperatorLogical lo = OperatorLogical::And) : field(f), op(o), value(v), logicOperator(lo)
+            // 参数按在 SQL 中出现的顺序以位置绑定，同一字段可出现在多个条件中
+            auto &query = this->activeQuery();
+            int pos = 0;
+            m_conditions.bind(query, pos, m_arrayBinding);
+            if (!m_afterField.isEmpty())
             {
+                query.bindValue(pos++, m_afterValue);
             }
-        };
+            if (m_page > 0 && m_pageSize > 0)
+            {
+                query.bindValue(pos++, m_pageSize);
+                query.bindValue(pos++, (m_page - 1) * m_pageSize);
+            }
+            else if (m_limit > 0)
+            {
+                query.bindValue(pos++, m_limit);
+            }
+
+            this->recordFlight();
+            if (!query.exec())
+            {
+                this->innerError();
+                return false;
+            }
+            this->m_success = true;
+            return true;
+        }
+
+        std::vector<T> readAll()
+        {
+            std::vector<T> results;
+            auto &query = this->activeQuery();
+            // 列号每个结果集只解析一次，逐行按列号取值
+            const auto columns = OrmMapper<T>::resolve(query.record());
+            while (query.next())
+            {
+                results.push_back(OrmMapper<T>::fromQuery(query, columns));
+            }
+            return results;
+        }
 
+        // 结果缓存键：语句形状加全部参数值（QDataStream 编码，区分类型）
+        QByteArray cacheKey() const
+        {
+            QByteArray key = shapeKey(false).toUtf8();
+            QDataStream stream(&key, QIODevice::Append);
+            m_conditions.appendValues(stream);
+            stream << m_afterValue << m_page << m_pageSize << m_limit;
+            return key;
+        }
+
+      private:
         QString buildSelectStatement() const
         {
             QString fields = m_fields.isEmpty() ? "*" : m_fields.join(", ");
             QString distinctClause = m_distinct ? "DISTINCT " : "";
             QString sql = QString("SELECT %1%2 FROM %3").arg(distinctClause, fields, T::tableName());
 
-            QString whereClause = buildWhereClause();
+            QString whereClause = m_conditions.clause(m_arrayBinding);
+            if (!m_afterField.isEmpty())
+            {
+                QString keyset = QString("%1 > ?").arg(m_afterField);
+                whereClause = whereClause.isEmpty() ? keyset : QString("(%1) AND %2").arg(whereClause, keyset);
+            }
             if (!whereClause.isEmpty())
             {
                 sql.append(" WHERE ").append(whereClause);
             }
-            if (!m_orderByClauses.isEmpty())
+            QStringList orderBy = m_orderByClauses;
+            if (!m_afterField.isEmpty())
             {
-                sql.append(" ORDER BY ").append(m_orderByClauses.join(", "));
+                orderBy.prepend(m_afterField + " ASC");
+            }
+            if (!orderBy.isEmpty())
+            {
+                sql.append(" ORDER BY ").append(orderBy.join(", "));
             }
             if (m_page > 0 && m_pageSize > 0)
             {
-                int offset = (m_page - 1) * m_pageSize;
-                sql.append(QString(" LIMIT %1 OFFSET %2").arg(m_pageSize).arg(offset));
+                // 分页参数以占位符绑定，翻页不改变语句形状
+                sql.append(" LIMIT ? OFFSET ?");
+            }
+            else if (m_limit > 0)
+            {
+                sql.append(" LIMIT ?");
             }
 
             sql.append(";");
             return sql;
         }
 
-        QString buildWhereClause() const
+        // 语句形状：决定 SQL 文本的全部要素，不含参数值
+        QString shapeKey(bool arrayBinding) const
         {
-            QStringList clauses;
-            for (const auto &condition : m_conditions)
+            QString key = T::tableName();
+            key.append(m_distinct ? QStringLiteral("|D|") : QStringLiteral("|"));
+            key.append(m_fields.join(','));
+            m_conditions.appendShape(key, arrayBinding);
+            key.append('|').append(m_orderByClauses.join(','));
+            if (!m_afterField.isEmpty())
             {
-                QString clause = QString("%1 %2 :%1").arg(condition.field, SqlOperators::comparisonOperatorMap.at(condition.op));
-                if (!clauses.isEmpty())
-                {
-                    clause = SqlOperators::logicalOperatorMap.at(condition.logicOperator) + " " + clause;
-                }
-                clauses.append(clause);
+                key.append(QStringLiteral("|K")).append(m_afterField);
+            }
+            if (m_page > 0 && m_pageSize > 0)
+            {
+                key.append(QStringLiteral("|P"));
+            }
+            else if (m_limit > 0)
+            {
+                key.append(QStringLiteral("|L"));
             }
-            return clauses.join(' ');
+            return key;
         }
 
         QStringList m_fields;
-        QList<Condition> m_conditions;
+        SqlConditions m_conditions;
         QStringList m_orderByClauses;
         int m_page = 0;
         int m_pageSize = 0;
-        bool m_distinct = false; // 是否去重
+        int m_limit = 0;
+        QString m_afterField; // 键集分页的键字段，空表示未启用
+        QVariant m_afterValue;
+        bool m_distinct = false;     // 是否去重
+        bool m_arrayBinding = false; // IN 是否以数组参数绑定
+        bool m_cache = false;
+        int m_cacheTtlMs = 0;
+        std::shared_ptr<const std::vector<T>> m_cachedRows; // 本次结果来自（或已存入）缓存
     };
 
 } // namespace _Kits
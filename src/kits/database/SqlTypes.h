@@ -17,7 +17,9 @@ enum class OperatorComparison
     GreaterThan,  // 大于
     LessThan,     // 小于
     GreaterEqual, // 大于等于
-    LessEqual     // 小于等于
+    LessEqual,    // 小于等于
+    In,           // 属于集合，值为 QVariantList；PostgreSQL 下以单个数组参数绑定（= ANY）
+    Between       // 闭区间，值为 QVariantList{下限, 上限}
 };
 
 // 逻辑操作符枚举
@@ -36,7 +38,9 @@ class SqlOperators
                                  {OperatorComparison::GreaterThan, ">"},
                                  {OperatorComparison::LessThan, "<"},
                                  {OperatorComparison::GreaterEqual, ">="},
-                                 {OperatorComparison::LessEqual, "<="}};
+                                 {OperatorComparison::LessEqual, "<="},
+                                 {OperatorComparison::In, "IN"},
+                                 {OperatorComparison::Between, "BETWEEN"}};
 
     // 定义逻辑操作符与字符串的映射
     inline static const std::unordered_map<OperatorLogical, QString>
@@ -0,0 +1,328 @@
+#pragma once
+#include "QueryResultCache.h"
+#include "SqlConditions.h"
+#include "SqlQuery.h"
+#include "kits/orm/OrmMapperImpl.h"
+#include <QDateTime>
+#include <QDebug>
+#include <QString>
+#include <QStringList>
+#include <QVariant>
+#include <algorithm>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace _Kits
+{
+    /**
+     * @brief 更新语句，两种用法：
+     *
+     * - 按条件更新：set() 指定列值，where() 指定条件，生成一条 UPDATE；没有条件时拒绝执行；
+     * - 按主键批量更新对象：update() 传入对象，按 id 把 columns() 指定的列（默认除 created_time 外全部）
+     *   写回，多行分块为 UPDATE ... FROM (VALUES ...)（MySQL 为 JOIN 派生表），整批在一个事务内。
+     *
+     * 两种用法都会把 updated_time 写为本次执行的时间（按条件更新时已 set 该列则以 set 为准）。
+     * @code
+     * SqlUpdate<device_status> update;
+     * update.set("details_json", json).whereIn("tag", tags).exec();
+     *
+     * SqlUpdate<radar_data> batch;
+     * batch.columns({"task_id"}).update(rows).exec();
+     * @endcode
+     */
+    template <typename T>
+    class SqlUpdate : public SqlQuery<T>
+    {
+      public:
+        SqlUpdate() = default;
+        SqlUpdate(SqlUpdate &&) = default;
+        SqlUpdate &operator=(SqlUpdate &&) = default;
+        virtual ~SqlUpdate() = default;
+
+        SqlUpdate &set(const QString &field, const QVariant &value)
+        {
+            m_sets.emplace_back(field, value);
+            return *this;
+        }
+
+        SqlUpdate &where(const QString &field, OperatorComparison op, const QVariant &value, OperatorLogical logicOperator = OperatorLogical::And)
+        {
+            m_conditions.add(field, op, value, logicOperator);
+            return *this;
+        }
+
+        SqlUpdate &whereIn(const QString &field, const QVariantList &values, OperatorLogical logicOperator = OperatorLogical::And)
+        {
+            return where(field, OperatorComparison::In, values, logicOperator);
+        }
+
+        // 批量更新时写回的列
+        SqlUpdate &columns(const QStringList &fields)
+        {
+            m_columns = fields;
+            return *this;
+        }
+
+        template <typename U, typename std::enable_if<std::is_same<T, U>::value, int>::type = 0>
+        SqlUpdate &update(const U &object)
+        {
+            m_rows.clear();
+            m_ids.clear();
+            appendRow(object, QDateTime::currentDateTime());
+            return *this;
+        }
+
+        template <typename Container, typename std::enable_if<!std::is_same<T, Container>::value, int>::type = 0>
+        SqlUpdate &update(const Container &objects)
+        {
+            m_rows.clear();
+            m_ids.clear();
+            m_rows.reserve(objects.size());
+            m_ids.reserve(objects.size());
+            const auto now = QDateTime::currentDateTime();
+            for (const auto &object : objects)
+            {
+                appendRow(object, now);
+            }
+            return *this;
+        }
+
+        virtual bool exec() override
+        {
+            m_numAffected = 0;
+            this->m_success = m_sets.empty() ? execBatch() : execWhere();
+            if (this->m_success)
+            {
+                QueryResultCache::instance().invalidate(T::tableName());
+            }
+            return this->m_success;
+        }
+
+        int getNumAffected()
+        {
+            return this->m_success ? m_numAffected : 0;
+        }
+
+      private:
+        void appendRow(const T &object, const QDateTime &now)
+        {
+            static const auto updatedIndex = OrmMapper<T>::valueColumns().indexOf(QStringLiteral("updated_time"));
+            auto row = OrmMapper<T>::toRow(object, now);
+            if (updatedIndex >= 0)
+            {
+                row[updatedIndex] = now;
+            }
+            m_rows.push_back(std::move(row));
+            m_ids.push_back(object.id);
+        }
+
+        bool execWhere()
+        {
+            if (m_conditions.isEmpty())
+            {
+                qDebug() << "SqlUpdate 没有条件，拒绝更新整张表:" << T::tableName();
+                return false;
+            }
+            auto sets = m_sets;
+            const bool stampUpdated = OrmMapper<T>::valueColumns().contains(QStringLiteral("updated_time")) &&
+                                      std::none_of(sets.begin(), sets.end(), [](const auto &set) { return set.first == QLatin1String("updated_time"); });
+            if (stampUpdated)
+            {
+                sets.emplace_back(QStringLiteral("updated_time"), QDateTime::currentDateTime());
+            }
+
+            const bool arrayBinding = this->database().driverName() == QLatin1String("QPSQL");
+            if (arrayBinding)
+            {
+                m_conditions.setArrayTypes(SqlQuery<T>::pgColumnTypes(this->database(), m_conditions.arrayFields()));
+            }
+            QStringList fields;
+            for (const auto &set : sets)
+            {
+                fields << set.first;
+            }
+            QString shape = QString("UPDATE|%1|%2").arg(T::tableName(), fields.join(','));
+            m_conditions.appendShape(shape, arrayBinding);
+            const bool prepared = this->prepareCached(shape, [&]() {
+                QStringList assignments;
+                for (const auto &field : fields)
+                {
+                    assignments << QString("%1 = ?").arg(field);
+                }
+                return QString("UPDATE %1 SET %2 WHERE %3").arg(T::tableName(), assignments.join(", "), m_conditions.clause(arrayBinding));
+            });
+            if (!prepared)
+            {
+                return false;
+            }
+
+            auto &query = this->activeQuery();
+            int pos = 0;
+            for (const auto &set : sets)
+            {
+                query.bindValue(pos++, set.second);
+            }
+            m_conditions.bind(query, pos, arrayBinding);
+            this->recordFlight();
+            if (!query.exec())
+            {
+                this->innerError();
+                return false;
+            }
+            m_numAffected = query.numRowsAffected();
+            return true;
+        }
+
+        bool execBatch()
+        {
+            if (m_rows.empty())
+            {
+                return true;
+            }
+            // 同一主键只保留最后一个对象
+            std::unordered_map<int, std::size_t> last;
+            for (std::size_t i = 0; i < m_ids.size(); ++i)
+            {
+                last[m_ids[i]] = i;
+            }
+            std::vector<std::size_t> rows;
+            rows.reserve(last.size());
+            for (std::size_t i = 0; i < m_ids.size(); ++i)
+            {
+                if (last[m_ids[i]] == i)
+                {
+                    rows.push_back(i);
+                }
+            }
+
+            const auto &fields = OrmMapper<T>::valueColumns();
+            QStringList targets;
+            std::vector<qsizetype> indexes;
+            for (const auto &field : m_columns.isEmpty() ? fields : m_columns)
+            {
+                const auto index = fields.indexOf(field);
+                if (index < 0 || (m_columns.isEmpty() && field == QLatin1String("created_time")))
+                {
+                    continue;
+                }
+                targets << field;
+                indexes.push_back(index);
+            }
+            // 只指定了部分列时 updated_time 仍随之更新
+            const auto updatedIndex = fields.indexOf(QStringLiteral("updated_time"));
+            if (updatedIndex >= 0 && !targets.contains(QStringLiteral("updated_time")))
+            {
+                targets << QStringLiteral("updated_time");
+                indexes.push_back(updatedIndex);
+            }
+            if (targets.isEmpty())
+            {
+                qDebug() << "SqlUpdate 没有可更新的列:" << T::tableName();
+                return false;
+            }
+
+            auto &db = this->database();
+            const bool mysql = db.driverName() == QLatin1String("QMYSQL");
+            QStringList casts; // PostgreSQL 的 VALUES 不会按目标列推断类型，每个参数显式转换
+            if (!mysql)
+            {
+                const auto types = SqlQuery<T>::pgColumnTypes(db, QStringList(targets) << QStringLiteral("id"));
+                if (types.empty())
+                {
+                    qDebug() << "SqlUpdate 无法读取列类型:" << T::tableName();
+                    return false;
+                }
+                casts << types.at(QStringLiteral("id"));
+                for (const auto &target : targets)
+                {
+                    casts << types.at(target);
+                }
+            }
+
+            db.transaction();
+            for (std::size_t offset = 0; offset < rows.size();)
+            {
+                const std::size_t count = this->chunkRows(rows.size() - offset, targets.size() + 1);
+                const auto shape = QString("UPDATE_BATCH|%1|%2|%3").arg(T::tableName(), targets.join(','), QString::number(count));
+                if (!this->prepareCached(shape, [&]() { return buildBatchStatement(count, targets, casts, mysql); }))
+                {
+                    db.rollback();
+                    return false;
+                }
+                auto &query = this->activeQuery();
+                int pos = 0;
+                for (std::size_t i = offset; i < offset + count; ++i)
+                {
+                    const auto &row = m_rows[rows[i]];
+                    query.bindValue(pos++, m_ids[rows[i]]);
+                    for (auto index : indexes)
+                    {
+                        query.bindValue(pos++, row[index]);
+                    }
+                }
+                this->recordFlight();
+                if (!query.exec())
+                {
+                    this->innerError();
+                    db.rollback();
+                    return false;
+                }
+                m_numAffected += query.numRowsAffected();
+                offset += count;
+            }
+            return db.commit();
+        }
+
+        static QString buildBatchStatement(std::size_t rows, const QStringList &targets, const QStringList &casts, bool mysql)
+        {
+            const QString table = T::tableName();
+            QStringList assignments;
+            QStringList tuples;
+            if (mysql)
+            {
+                // 首行用别名给派生表列命名
+                QStringList first{QStringLiteral("? AS id")};
+                QStringList rest{QStringLiteral("?")};
+                for (const auto &target : targets)
+                {
+                    first << QString("? AS %1").arg(target);
+                    rest << QStringLiteral("?");
+                    assignments << QString("%1.%2 = v.%2").arg(table, target);
+                }
+                tuples << "SELECT " + first.join(", ");
+                for (std::size_t i = 1; i < rows; ++i)
+                {
+                    tuples << "SELECT " + rest.join(", ");
+                }
+                return QString("UPDATE %1 JOIN (%2) AS v ON %1.id = v.id SET %3")
+                    .arg(table, tuples.join(" UNION ALL "), assignments.join(", "));
+            }
+
+            QStringList placeholders;
+            for (const auto &cast : casts)
+            {
+                placeholders << QString("CAST(? AS %1)").arg(cast);
+            }
+            const QString tuple = QString("(%1)").arg(placeholders.join(", "));
+            for (std::size_t i = 0; i < rows; ++i)
+            {
+                tuples << tuple;
+            }
+            for (const auto &target : targets)
+            {
+                assignments << QString("%1 = v.%1").arg(target);
+            }
+            return QString("UPDATE %1 SET %2 FROM (VALUES %3) AS v (id, %4) WHERE %1.id = v.id")
+                .arg(table, assignments.join(", "), tuples.join(", "), targets.join(", "));
+        }
+
+        std::vector<std::pair<QString, QVariant>> m_sets;
+        SqlConditions m_conditions;
+        QStringList m_columns;
+        std::vector<std::vector<QVariant>> m_rows; // 每行按 valueColumns() 顺序
+        std::vector<int> m_ids;
+        int m_numAffected = 0;
+    };
+
+} // namespace _Kits
@@ -0,0 +1,245 @@
+#pragma once
+#include "QueryResultCache.h"
+#include "SqlQuery.h"
+#include "kits/orm/OrmMapperImpl.h"
+#include <QDateTime>
+#include <QDebug>
+#include <QString>
+#include <QStringList>
+#include <QVariant>
+#include <unordered_map>
+#include <vector>
+
+namespace _Kits
+{
+    /**
+     * @brief 插入或更新：INSERT ... ON CONFLICT (keys) DO UPDATE（MySQL 为 ON DUPLICATE KEY UPDATE）。
+     *
+     * 冲突列须有唯一约束或唯一索引；MySQL 不指定冲突列，按表上任一唯一键判断。
+     * 批量时按多行 VALUES 分块执行，整批在一个事务内；同一批中冲突键相同的对象只保留最后一个。
+     * updated_time 列一律写为本次执行的时间。
+     * @code
+     * std::vector<device_status> states = ...;
+     * SqlUpsert<device_status> upsert;
+     * upsert.onConflict({"tag"}).upsert(states).exec();
+     * @endcode
+     */
+    template <typename T>
+    class SqlUpsert : public SqlQuery<T>
+    {
+      public:
+        SqlUpsert() = default;
+        SqlUpsert(SqlUpsert &&) = default;
+        SqlUpsert &operator=(SqlUpsert &&) = default;
+        virtual ~SqlUpsert() = default;
+
+        // 冲突判定列
+        SqlUpsert &onConflict(const QStringList &keys)
+        {
+            m_keys = keys;
+            return *this;
+        }
+
+        // 冲突时更新的列，默认为冲突列与 created_time 以外的全部写入列
+        SqlUpsert &updateColumns(const QStringList &fields)
+        {
+            m_updateColumns = fields;
+            return *this;
+        }
+
+        template <typename U, typename std::enable_if<std::is_same<T, U>::value, int>::type = 0>
+        SqlUpsert &upsert(const U &object)
+        {
+            m_rows.clear();
+            appendRow(object, QDateTime::currentDateTime());
+            return *this;
+        }
+
+        template <typename Container, typename std::enable_if<!std::is_same<T, Container>::value, int>::type = 0>
+        SqlUpsert &upsert(const Container &objects)
+        {
+            m_rows.clear();
+            m_rows.reserve(objects.size());
+            const auto now = QDateTime::currentDateTime();
+            for (const auto &object : objects)
+            {
+                appendRow(object, now);
+            }
+            return *this;
+        }
+
+        virtual bool exec() override
+        {
+            this->m_success = false;
+            m_numAffected = 0;
+            if (m_rows.empty())
+            {
+                this->m_success = true;
+                return true;
+            }
+            if (m_keys.isEmpty())
+            {
+                qDebug() << "SqlUpsert 未指定冲突列:" << T::tableName();
+                return false;
+            }
+            const auto rows = uniqueRows();
+            const bool mysql = this->database().driverName() == QLatin1String("QMYSQL");
+            const auto updates = updateTargets();
+            const std::size_t columns = OrmMapper<T>::valueCount;
+
+            auto &db = this->database();
+            if (!db.transaction())
+            {
+                qDebug() << "SqlUpsert 开启事务失败:" << db.lastError().text();
+                return false;
+            }
+            for (std::size_t offset = 0; offset < rows.size();)
+            {
+                const std::size_t count = this->chunkRows(rows.size() - offset, columns);
+                const auto shape = QString("UPSERT|%1|%2|%3|%4").arg(T::tableName(), m_keys.join(','), updates.join(','), QString::number(count));
+                if (!this->prepareCached(shape, [&]() { return buildSqlStatement(count, updates, mysql); }))
+                {
+                    db.rollback();
+                    m_numAffected = 0;
+                    return false;
+                }
+                auto &query = this->activeQuery();
+                int pos = 0;
+                for (std::size_t i = offset; i < offset + count; ++i)
+                {
+                    for (const auto &value : m_rows[rows[i]])
+                    {
+                        query.bindValue(pos++, value);
+                    }
+                }
+                this->recordFlight();
+                if (!query.exec())
+                {
+                    this->innerError();
+                    db.rollback();
+                    m_numAffected = 0;
+                    return false;
+                }
+                m_numAffected += query.numRowsAffected();
+                offset += count;
+            }
+            this->m_success = db.commit();
+            if (!this->m_success)
+            {
+                qDebug() << "SqlUpsert 提交失败:" << db.lastError().text();
+                m_numAffected = 0;
+            }
+            QueryResultCache::instance().invalidate(T::tableName());
+            return this->m_success;
+        }
+
+        // 影响行数：PostgreSQL 为插入与更新的行数之和；MySQL 更新的行计 2
+        int getNumAffected()
+        {
+            return this->m_success ? m_numAffected : 0;
+        }
+
+      private:
+        void appendRow(const T &object, const QDateTime &now)
+        {
+            static const auto updatedIndex = OrmMapper<T>::valueColumns().indexOf(QStringLiteral("updated_time"));
+            auto row = OrmMapper<T>::toRow(object, now);
+            if (updatedIndex >= 0)
+            {
+                row[updatedIndex] = now;
+            }
+            m_rows.push_back(std::move(row));
+        }
+
+        // 同一条语句不能两次更新同一行，按冲突键去重，保留最后一个对象
+        std::vector<std::size_t> uniqueRows() const
+        {
+            const auto &fields = OrmMapper<T>::valueColumns();
+            std::vector<qsizetype> keyIndexes;
+            for (const auto &key : m_keys)
+            {
+                keyIndexes.push_back(fields.indexOf(key));
+            }
+            std::unordered_map<QString, std::size_t> last;
+            std::vector<QString> rowKeys(m_rows.size());
+            for (std::size_t i = 0; i < m_rows.size(); ++i)
+            {
+                QStringList parts;
+                for (auto index : keyIndexes)
+                {
+                    parts << (index >= 0 ? m_rows[i][index].toString() : QString());
+                }
+                rowKeys[i] = parts.join(QChar(0x1f));
+                last[rowKeys[i]] = i;
+            }
+            std::vector<std::size_t> rows;
+            rows.reserve(last.size());
+            for (std::size_t i = 0; i < m_rows.size(); ++i)
+            {
+                if (last[rowKeys[i]] == i)
+                {
+                    rows.push_back(i);
+                }
+            }
+            return rows;
+        }
+
+        QStringList updateTargets() const
+        {
+            if (!m_updateColumns.isEmpty())
+            {
+                return m_updateColumns;
+            }
+            QStringList fields;
+            for (const auto &field : OrmMapper<T>::valueColumns())
+            {
+                if (!m_keys.contains(field) && field != QLatin1String("created_time"))
+                {
+                    fields << field;
+                }
+            }
+            return fields;
+        }
+
+        QString buildSqlStatement(std::size_t rows, const QStringList &updates, bool mysql) const
+        {
+            const auto &fields = OrmMapper<T>::valueColumns();
+            QStringList placeholders;
+            for (qsizetype i = 0; i < fields.size(); ++i)
+            {
+                placeholders << QStringLiteral("?");
+            }
+            const QString tuple = QString("(%1)").arg(placeholders.join(", "));
+            QStringList tuples;
+            for (std::size_t i = 0; i < rows; ++i)
+            {
+                tuples << tuple;
+            }
+            QString sql = QString("INSERT INTO %1 (%2) VALUES %3").arg(T::tableName(), fields.join(", "), tuples.join(", "));
+
+            QStringList assignments;
+            for (const auto &field : updates)
+            {
+                assignments << (mysql ? QString("%1 = VALUES(%1)") : QString("%1 = EXCLUDED.%1")).arg(field);
+            }
+            if (mysql)
+            {
+                // MySQL 没有 DO NOTHING，以冲突列赋值给自身代替
+                sql.append(" ON DUPLICATE KEY UPDATE ")
+                    .append(assignments.isEmpty() ? QString("%1 = %1").arg(m_keys.front()) : assignments.join(", "));
+            }
+            else
+            {
+                sql.append(QString(" ON CONFLICT (%1) ").arg(m_keys.join(", ")))
+                    .append(assignments.isEmpty() ? QStringLiteral("DO NOTHING") : "DO UPDATE SET " + assignments.join(", "));
+            }
+            return sql;
+        }
+
+        QStringList m_keys;
+        QStringList m_updateColumns;
+        std::vector<std::vector<QVariant>> m_rows; // 每行按 valueColumns() 顺序
+        int m_numAffected = 0;
+    };
+
+} // namespace _Kits
@@ -0,0 +1,324 @@
+#include "WriteBehind.h"
+#include "kits/required/config/ConfigService.h"
+#include "kits/required/log/CRossLogger.h"
+#include <QDateTime>
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+
+namespace _Kits
+{
+    namespace detail
+    {
+        static constexpr std::size_t kSpillFileSize = 8 * 1024 * 1024;
+
+        SpillStore::SpillStore(std::string directory, std::string table)
+            : m_directory(std::move(directory) + "/" + table)
+        {
+            // 上次运行未补写完的分段
+            std::error_code ec;
+            for (const auto &entry : std::filesystem::directory_iterator(m_directory, ec))
+            {
+                if (entry.path().extension() == ".ndjson")
+                {
+                    ++m_files;
+                }
+            }
+        }
+
+        bool SpillStore::empty()
+        {
+            std::lock_guard locker(m_mutex);
+            return m_files == 0;
+        }
+
+        void SpillStore::reject(const QByteArray &line)
+        {
+            std::lock_guard locker(m_mutex);
+            std::ofstream file(m_directory + "/rejected.log", std::ios::binary | std::ios::app);
+            file.write(line.constData(), line.size());
+            file.put('\n');
+        }
+
+        void SpillStore::append(const std::vector<QByteArray> &lines)
+        {
+            if (lines.empty())
+            {
+                return;
+            }
+            std::lock_guard locker(m_mutex);
+            std::error_code ec;
+            std::filesystem::create_directories(m_directory, ec);
+            if (m_current.empty() || m_currentSize >= kSpillFileSize)
+            {
+                // 文件名以时间开头、序号定长，按名称排序即为写入顺序
+                m_current = m_directory + "/" +
+                            QDateTime::currentDateTime().toString("yyyyMMddHHmmsszzz").toStdString() + "_" +
+                            QString("%1").arg(m_sequence++, 8, 10, QChar('0')).toStdString() + ".ndjson";
+                m_currentSize = 0;
+                ++m_files;
+            }
+            std::ofstream file(m_current, std::ios::binary | std::ios::app);
+            for (const auto &line : lines)
+            {
+                file.write(line.constData(), line.size());
+                file.put('\n');
+                m_currentSize += line.size() + 1;
+            }
+            if (!file)
+            {
+                LogError("write-behind spill failed: {}", m_current);
+            }
+        }
+
+        std::string SpillStore::takeOldest(std::vector<QByteArray> &lines)
+        {
+            std::lock_guard locker(m_mutex);
+            std::error_code ec;
+            std::vector<std::string> files;
+            for (const auto &entry : std::filesystem::directory_iterator(m_directory, ec))
+            {
+                if (entry.path().extension() == ".ndjson")
+                {
+                    files.push_back(entry.path().string());
+                }
+            }
+            if (files.empty())
+            {
+                return {};
+            }
+            std::sort(files.begin(), files.end());
+            const auto &oldest = files.front();
+            if (oldest == m_current)
+            {
+                m_current.clear(); // 不再向该文件追加，之后的暂存写入新文件
+            }
+            std::ifstream file(oldest, std::ios::binary);
+            std::string line;
+            while (std::getline(file, line))
+            {
+                if (!line.empty())
+                {
+                    lines.push_back(QByteArray::fromStdString(line));
+                }
+            }
+            return oldest;
+        }
+
+        void SpillStore::finish(const std::string &path, const std::vector<QByteArray> &remaining)
+        {
+            std::lock_guard locker(m_mutex);
+            std::error_code ec;
+            if (remaining.empty())
+            {
+                if (std::filesystem::remove(path, ec) && m_files > 0)
+                {
+                    --m_files;
+                }
+                return;
+            }
+            // 只保留未补写成功的行，下次从这里继续
+            std::ofstream file(path, std::ios::binary | std::ios::trunc);
+            for (const auto &line : remaining)
+            {
+                file.write(line.constData(), line.size());
+                file.put('\n');
+            }
+        }
+    } // namespace detail
+
+    WriteBehind::WriteBehind()
+    {
+        auto config = ConfigService::instance().snapshot();
+        const auto &database = config->database;
+        m_options.batchSize = std::max(database.writeBatchSize, 1);
+        m_options.flushIntervalMs = std::max(database.writeFlushIntervalMs, 1);
+        m_options.maxPendingRows = std::max(database.writeMaxPendingRows, m_options.batchSize);
+        m_options.backpressureMs = std::max(database.writeBackpressureMs, 0);
+        m_options.replayBatchSize = std::max(database.writeReplayBatchSize, m_options.batchSize);
+        m_options.copyReplay = database.rdbms == "postgresql";
+        m_options.spillDirectory = (config->savePath.empty() ? ConfigService::instance().appDirectory() : config->savePath) + "/spill";
+        m_flusher = std::thread([this]() { flushLoop(); });
+    }
+
+    WriteBehind::~WriteBehind()
+    {
+        stop();
+    }
+
+    void WriteBehind::stop()
+    {
+        if (!m_running.exchange(false))
+        {
+            return;
+        }
+        m_flushCv.notify_all();
+        if (m_flusher.joinable())
+        {
+            m_flusher.join();
+        }
+        flushOnce(true);
+    }
+
+    void WriteBehind::flush()
+    {
+        while (flushOnce(true) > 0)
+        {
+        }
+    }
+
+    std::map<std::string, WriteBehindStats> WriteBehind::stats()
+    {
+        std::lock_guard locker(m_mutex);
+        std::map<std::string, WriteBehindStats> result;
+        for (const auto &table : m_tables)
+        {
+            result.emplace(table->table().toStdString(), table->stats());
+        }
+        return result;
+    }
+
+    bool WriteBehind::reserve()
+    {
+        const auto limit = static_cast<std::size_t>(m_options.maxPendingRows);
+        if (m_pending.fetch_add(1) < limit)
+        {
+            return true;
+        }
+        m_pending.fetch_sub(1);
+        ++m_backpressureWaits;
+        m_flushCv.notify_one();
+        std::unique_lock locker(m_mutex);
+        bool ok = m_capacityCv.wait_for(locker, std::chrono::milliseconds(m_options.backpressureMs), [this, limit]() {
+            return m_pending.load() < limit || !m_running;
+        });
+        if (ok && m_running)
+        {
+            m_pending.fetch_add(1);
+            return true;
+        }
+        return false;
+    }
+
+    void WriteBehind::release(std::size_t rows)
+    {
+        if (rows == 0)
+        {
+            return;
+        }
+        m_pending.fetch_sub(rows);
+        {
+            // 与等待方的条件检查串行，避免丢失唤醒
+            std::lock_guard locker(m_mutex);
+        }
+        m_capacityCv.notify_all();
+    }
+
+    void WriteBehind::addTable(std::unique_ptr<detail::WriteBehindTable> &&table)
+    {
+        std::lock_guard locker(m_mutex);
+        m_tables.push_back(std::move(table));
+    }
+
+    std::size_t WriteBehind::flushOnce(bool force)
+    {
+        std::vector<detail::WriteBehindTable *> tables;
+        {
+            std::lock_guard locker(m_mutex);
+            for (const auto &table : m_tables)
+            {
+                tables.push_back(table.get());
+            }
+        }
+        const auto due = Clock::now() - std::chrono::milliseconds(m_options.flushIntervalMs);
+        // 数据库不可用时到期的批次直接写入日志，不逐批等待连接超时
+        const bool wasOffline = isOffline();
+        bool offline = wasOffline;
+        std::size_t total = 0;
+        for (auto *table : tables)
+        {
+            std::size_t rows = 0;
+            while ((rows = table->flush(m_options.batchSize, due, force, offline)) > 0)
+            {
+                release(rows);
+                total += rows;
+            }
+        }
+        if (offline && !wasOffline)
+        {
+            setOffline(true);
+        }
+        return total;
+    }
+
+    bool WriteBehind::replayOnce()
+    {
+        if (!DatabaseManager::isReady())
+        {
+            return false;
+        }
+        std::vector<detail::WriteBehindTable *> tables;
+        {
+            std::lock_guard locker(m_mutex);
+            for (const auto &table : m_tables)
+            {
+                tables.push_back(table.get());
+            }
+        }
+        for (auto *table : tables)
+        {
+            if (!table->replay())
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void WriteBehind::setOffline(bool offline)
+    {
+        if (m_offline.exchange(offline) == offline)
+        {
+            return;
+        }
+        if (offline)
+        {
+            LogWarn("database unavailable, write-behind journaling to {}", m_options.spillDirectory);
+        }
+        else
+        {
+            LogInfo("database available, write-behind journal replay resumed");
+        }
+    }
+
+    void WriteBehind::flushLoop()
+    {
+        constexpr auto kMinRetry = std::chrono::seconds(1);
+        constexpr auto kMaxRetry = std::chrono::seconds(30);
+        auto nextReplay = Clock::now();
+        Clock::duration retry = kMinRetry;
+        while (m_running)
+        {
+            {
+                std::unique_lock locker(m_mutex);
+                m_flushCv.wait_for(locker, std::chrono::milliseconds(m_options.flushIntervalMs));
+            }
+            flushOnce(false);
+
+            // 缓冲写空后按顺序补写日志，补写即探测数据库是否恢复；失败后指数退避
+            if (m_pending == 0 && Clock::now() >= nextReplay)
+            {
+                if (replayOnce())
+                {
+                    retry = kMinRetry;
+                    setOffline(false);
+                }
+                else
+                {
+                    nextReplay = Clock::now() + retry;
+                    retry = std::min<Clock::duration>(retry * 2, kMaxRetry);
+                }
+            }
+        }
+    }
+} // namespace _Kits
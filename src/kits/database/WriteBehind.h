@@ -0,0 +1,463 @@
+#pragma once
+#include "SqlCopy.h"
+#include "SqlInsert.h"
+#include "kits/required/log/CRossLogger.h"
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace _Kits
+{
+struct WriteBehindOptions
+{
+    int batchSize = 500;          // 单表攒够多少行立即落库
+    int flushIntervalMs = 200;    // 最早一行等待超过该时长即落库
+    int maxPendingRows = 50000;   // 全部表待写行数上限，超过后写入方等待
+    int backpressureMs = 50;      // 写入方最长等待，仍无空间则落盘暂存
+    int replayBatchSize = 5000;   // 日志补写单批行数
+    bool copyReplay = false;      // 补写以二进制 COPY 写入（PostgreSQL）
+    std::string spillDirectory;   // 数据库落后或不可用时的日志目录
+};
+
+// 单表统计，时间单位微秒
+struct WriteBehindStats
+{
+    uint64_t queued = 0;   // 累计入队行数
+    uint64_t flushed = 0;  // 成功写入数据库的行数
+    uint64_t spilled = 0;  // 写入暂存文件的行数
+    uint64_t replayed = 0; // 从暂存文件补写成功的行数
+    uint64_t rejected = 0; // 补写时逐行重试仍失败、移出日志的行数
+    uint64_t batches = 0;  // 成功批次数
+    uint64_t failures = 0; // 失败批次数
+    int64_t lastFlushUs = 0;
+    int64_t maxFlushUs = 0;
+    int64_t totalFlushUs = 0;
+    std::size_t maxBatch = 0;
+    std::size_t pending = 0;
+};
+
+namespace detail
+{
+    // 暂存日志：按表分目录的只追加分段文件，每行一条 JSON 记录，文件名顺序即写入顺序
+    class SpillStore
+    {
+      public:
+        SpillStore(std::string directory, std::string table);
+        void append(const std::vector<QByteArray> &lines);
+        /// @brief 取最早的暂存文件内容，返回文件路径（无文件时为空）
+        std::string takeOldest(std::vector<QByteArray> &lines);
+        void finish(const std::string &path, const std::vector<QByteArray> &remaining);
+        /// @brief 无法写入数据库的行移入 rejected.log，不再补写
+        void reject(const QByteArray &line);
+        /// @brief 是否还有未补写的分段（含上次运行遗留的）
+        bool empty();
+
+      private:
+        std::mutex m_mutex;
+        std::string m_directory;
+        std::string m_current; // 正在追加的文件，补写时不会读取
+        std::size_t m_currentSize = 0;
+        std::size_t m_files = 0; // 未补写完的分段数
+        uint64_t m_sequence = 0;
+    };
+
+    class WriteBehindTable
+    {
+      public:
+        using Clock = std::chrono::steady_clock;
+        WriteBehindTable(const QString &table, const WriteBehindOptions &options)
+            : m_table(table), m_options(options), m_spill(options.spillDirectory, table.toStdString())
+        {
+        }
+        virtual ~WriteBehindTable() = default;
+
+        const QString &table() const
+        {
+            return m_table;
+        }
+        /// @brief 满足数量或时间条件时取出一批，返回取出行数
+        /// @param offline 为 true 时直接写入日志；写入时发现数据库不可用则置为 true
+        virtual std::size_t flush(int batchSize, Clock::time_point due, bool force, bool &offline) = 0;
+        /// @brief 按顺序补写最早的一个暂存文件，数据库不可用时返回 false
+        virtual bool replay() = 0;
+        WriteBehindStats stats()
+        {
+            std::lock_guard locker(m_mutex);
+            return m_stats;
+        }
+
+      protected:
+        template <typename T>
+        static QByteArray encode(const T &row)
+        {
+            QVariantMap map;
+            for (const auto &[key, value] : OrmMapper<T>::toMap(row))
+            {
+                // 二进制列（如 points_bin）以 base64 存入 JSON
+                map.insert(QString::fromStdString(key),
+                           value.typeId() == QMetaType::QByteArray ? QVariant(QString::fromLatin1(value.toByteArray().toBase64())) : value);
+            }
+            return QJsonDocument(QJsonObject::fromVariantMap(map)).toJson(QJsonDocument::Compact);
+        }
+        template <typename T>
+        static T decode(const QByteArray &line)
+        {
+            static const auto fieldTypes = OrmMapper<T>::toMap(T{});
+            std::unordered_map<std::string, QVariant> map;
+            const auto values = QJsonDocument::fromJson(line).object().toVariantMap();
+            for (auto it = values.begin(); it != values.end(); ++it)
+            {
+                auto key = it.key().toStdString();
+                auto type = fieldTypes.find(key);
+                if (type != fieldTypes.end() && type->second.typeId() == QMetaType::QByteArray)
+                {
+                    map.emplace(std::move(key), QByteArray::fromBase64(it.value().toString().toLatin1()));
+                    continue;
+                }
+                map.emplace(std::move(key), it.value());
+            }
+            return OrmMapper<T>::fromMap(map);
+        }
+        void recordFlush(std::size_t rows, int64_t us, bool ok)
+        {
+            std::lock_guard locker(m_mutex);
+            if (!ok)
+            {
+                ++m_stats.failures;
+                return;
+            }
+            ++m_stats.batches;
+            m_stats.flushed += rows;
+            m_stats.lastFlushUs = us;
+            m_stats.totalFlushUs += us;
+            m_stats.maxFlushUs = std::max(m_stats.maxFlushUs, us);
+            m_stats.maxBatch = std::max(m_stats.maxBatch, rows);
+        }
+
+        QString m_table;
+        WriteBehindOptions m_options;
+        std::mutex m_mutex; // 保护缓冲与统计
+        WriteBehindStats m_stats;
+        SpillStore m_spill;
+    };
+
+    template <typename T>
+    class WriteBehindTableImpl final : public WriteBehindTable
+    {
+      public:
+        using WriteBehindTable::WriteBehindTable;
+
+        void push(T &&row)
+        {
+            std::lock_guard locker(m_mutex);
+            if (m_rows.empty())
+            {
+                m_oldest = Clock::now();
+            }
+            m_rows.push_back(std::move(row));
+            ++m_stats.queued;
+            m_stats.pending = m_rows.size();
+        }
+
+        std::size_t pending()
+        {
+            std::lock_guard locker(m_mutex);
+            return m_rows.size();
+        }
+
+        void spill(std::vector<T> &&rows)
+        {
+            std::vector<QByteArray> lines;
+            lines.reserve(rows.size());
+            for (const auto &row : rows)
+            {
+                lines.push_back(encode(row));
+            }
+            m_spill.append(lines);
+            std::lock_guard locker(m_mutex);
+            m_stats.spilled += rows.size();
+        }
+
+        std::size_t flush(int batchSize, Clock::time_point due, bool force, bool &offline) override
+        {
+            std::vector<T> batch;
+            {
+                std::lock_guard locker(m_mutex);
+                if (m_rows.empty() ||
+                    (!force && m_rows.size() < static_cast<std::size_t>(batchSize) && m_oldest > due))
+                {
+                    return 0;
+                }
+                if (m_rows.size() <= static_cast<std::size_t>(batchSize))
+                {
+                    batch.swap(m_rows);
+                }
+                else
+                {
+                    batch.assign(std::make_move_iterator(m_rows.begin()),
+                                 std::make_move_iterator(m_rows.begin() + batchSize));
+                    m_rows.erase(m_rows.begin(), m_rows.begin() + batchSize);
+                }
+                m_oldest = Clock::now();
+                m_stats.pending = m_rows.size();
+            }
+            const auto rows = batch.size();
+            writeThrough(std::move(batch), offline);
+            return rows;
+        }
+
+        /// @brief 直接写入，失败或需要保序时写入日志，返回是否已落库
+        bool writeThrough(std::vector<T> &&batch, bool &offline)
+        {
+            // 仍有未补写的日志时新数据也追加到日志，保证同一张表按写入顺序落库
+            if (!offline && m_spill.empty())
+            {
+                const auto result = write(batch, false);
+                if (result == WriteResult::ok)
+                {
+                    return true;
+                }
+                offline = result == WriteResult::offline;
+            }
+            spill(std::move(batch));
+            return false;
+        }
+
+        bool replay() override
+        {
+            std::vector<QByteArray> lines;
+            auto path = m_spill.takeOldest(lines);
+            if (path.empty())
+            {
+                return true;
+            }
+            const auto chunk = static_cast<std::size_t>(std::max(m_options.replayBatchSize, 1));
+            bool online = true;
+            std::size_t done = 0;
+            while (online && done < lines.size())
+            {
+                const auto end = std::min(lines.size(), done + chunk);
+                std::vector<T> batch;
+                batch.reserve(end - done);
+                for (auto i = done; i < end; ++i)
+                {
+                    batch.push_back(decode<T>(lines[i]));
+                }
+                auto result = write(batch, m_options.copyReplay);
+                if (result == WriteResult::ok)
+                {
+                    std::lock_guard locker(m_mutex);
+                    m_stats.replayed += batch.size();
+                    done = end;
+                    continue;
+                }
+                if (result == WriteResult::offline)
+                {
+                    online = false;
+                    break;
+                }
+                // 批内有无法写入的行（约束冲突、数据错误等）：逐行重试，仍失败的移出日志，避免阻塞后续数据
+                for (auto i = done; i < end; ++i)
+                {
+                    std::vector<T> one{std::move(batch[i - done])};
+                    result = write(one, false);
+                    if (result == WriteResult::offline)
+                    {
+                        online = false;
+                        break;
+                    }
+                    if (result == WriteResult::rejected)
+                    {
+                        m_spill.reject(lines[i]);
+                        LogError("write-behind rejected a {} row: {}", m_table.toStdString(), lines[i].toStdString());
+                    }
+                    {
+                        std::lock_guard locker(m_mutex);
+                        ++(result == WriteResult::ok ? m_stats.replayed : m_stats.rejected);
+                    }
+                    done = i + 1;
+                }
+            }
+            m_spill.finish(path, std::vector<QByteArray>(lines.begin() + done, lines.end()));
+            return online && done == lines.size();
+        }
+
+      private:
+        enum class WriteResult
+        {
+            ok,
+            offline,  // 数据库不可用，整批稍后重试
+            rejected, // 数据库可用但写入失败
+        };
+
+        WriteResult write(std::vector<T> &batch, bool bulk)
+        {
+            auto begin = Clock::now();
+            bool ok = false;
+            bool lost = false;
+            if (bulk)
+            {
+                SqlCopy<T> copy;
+                ok = copy.copy(batch).exec();
+                lost = !ok && copy.connectionLost();
+            }
+            // COPY 不支持的列类型或批内有坏行时退回 INSERT，以便定位坏行
+            if (!ok && !lost)
+            {
+                SqlInsert<T> insert;
+                ok = insert.insert(batch).exec();
+                lost = !ok && insert.connectionLost();
+            }
+            auto us = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - begin).count();
+            recordFlush(batch.size(), us, ok);
+            return ok ? WriteResult::ok : lost ? WriteResult::offline : WriteResult::rejected;
+        }
+
+        std::vector<T> m_rows;
+        Clock::time_point m_oldest;
+    };
+} // namespace detail
+
+/**
+ * @brief 写后落库：任意线程提交 ORM 结构体，按表攒批，后台线程以批量事务写入。
+ *
+ * - 单表攒够 batchSize 行或最早一行等待超过 flushIntervalMs 时落库；
+ * - 全部表待写行数超过 maxPendingRows 时，写入方最多等待 backpressureMs，
+ *   仍无空间则直接写入暂存日志；
+ * - 数据库未就绪或不可用时到期的批次直接写入日志（<save_path>/spill/<表名>/），内存占用不随断线时长增长；
+ * - 数据库恢复后按文件顺序补写，PostgreSQL 以 COPY 成批写入；某表日志未补写完之前，
+ *   该表的新数据也追加到日志，保证按写入顺序落库；
+ * - 补写中数据库可用却写不进的行逐行重试后移入 rejected.log，不阻塞后续数据；
+ * - 进程退出时写入剩余数据，无法写入的落盘。
+ *
+ * @code
+ * writeBehind().push(radar_data{...});
+ * // 需要同步写入又不能丢数据时
+ * writeBehind().writeThrough(std::move(rows));
+ * @endcode
+ */
+class WriteBehind
+{
+  public:
+    using Clock = std::chrono::steady_clock;
+
+    static WriteBehind &instance()
+    {
+        static WriteBehind writer;
+        return writer;
+    }
+    ~WriteBehind();
+
+    template <typename T>
+    void push(T row)
+    {
+        // 入队即视为写入时间，落库可能晚于此
+        OrmMapper<T>::stamp(row, QDateTime::currentDateTime());
+        auto &table = tableOf<T>();
+        if (!reserve())
+        {
+            std::vector<T> rows;
+            rows.push_back(std::move(row));
+            table.spill(std::move(rows));
+            return;
+        }
+        table.push(std::move(row));
+        if (table.pending() >= static_cast<std::size_t>(m_options.batchSize))
+        {
+            m_flushCv.notify_one();
+        }
+    }
+
+    /// @brief 同步写入一批行，数据库不可用、写入失败或该表仍有未补写的日志时写入日志由后台补写
+    /// @return true 表示已直接落库，false 表示已写入日志
+    template <typename T>
+    bool writeThrough(std::vector<T> rows)
+    {
+        if (rows.empty())
+        {
+            return true;
+        }
+        const auto now = QDateTime::currentDateTime();
+        for (auto &row : rows)
+        {
+            OrmMapper<T>::stamp(row, now);
+        }
+        bool offline = isOffline();
+        bool ok = tableOf<T>().writeThrough(std::move(rows), offline);
+        if (offline)
+        {
+            setOffline(true);
+        }
+        return ok;
+    }
+
+    /// @brief 立即写入全部缓冲（阻塞到完成）
+    void flush();
+    void stop();
+    std::map<std::string, WriteBehindStats> stats();
+    uint64_t backpressureWaits() const
+    {
+        return m_backpressureWaits;
+    }
+    /// @brief 是否处于断线写日志状态
+    bool isOffline() const
+    {
+        return m_offline || !DatabaseManager::isReady();
+    }
+    const WriteBehindOptions &options() const
+    {
+        return m_options;
+    }
+
+  protected:
+    WriteBehind();
+    WriteBehind(const WriteBehind &) = delete;
+    WriteBehind &operator=(const WriteBehind &) = delete;
+
+  private:
+    template <typename T>
+    detail::WriteBehindTableImpl<T> &tableOf()
+    {
+        static detail::WriteBehindTableImpl<T> *table = [this]() {
+            auto created = std::make_unique<detail::WriteBehindTableImpl<T>>(T::tableName(), m_options);
+            auto *raw = created.get();
+            addTable(std::move(created));
+            return raw;
+        }();
+        return *table;
+    }
+
+    bool reserve();
+    void release(std::size_t rows);
+    void addTable(std::unique_ptr<detail::WriteBehindTable> &&table);
+    void flushLoop();
+    std::size_t flushOnce(bool force);
+    bool replayOnce();
+    void setOffline(bool offline);
+
+    WriteBehindOptions m_options;
+    std::mutex m_mutex; // 保护表列表与等待状态
+    std::condition_variable m_flushCv;
+    std::condition_variable m_capacityCv;
+    std::vector<std::unique_ptr<detail::WriteBehindTable>> m_tables;
+    std::atomic<std::size_t> m_pending{0};
+    std::atomic<uint64_t> m_backpressureWaits{0};
+    std::atomic<bool> m_running{true};
+    std::atomic<bool> m_offline{false}; // 最近一次写入发现数据库不可用，补写成功后恢复
+    std::thread m_flusher;
+};
+
+inline WriteBehind &writeBehind()
+{
+    return WriteBehind::instance();
+}
+} // namespace _Kits
@@ -1,9 +1,16 @@
 // Auto-generated template implementations, 不要自己改，有问题问我！
 #pragma once
 #include "TableStructs.h"
+#include <array>
+#include <string_view>
 #include <unordered_map>
-#include <QVariant>
+#include <vector>
+#include <QSqlQuery>
 #include <QSqlRecord>
+#include <QStringList>
+#include <QDateTime>
+#include <QVariant>
+#include <QVariantList>
 
 // === 通用 ORM 宏定义 ===
 namespace _Kits {
@@ -12,6 +19,25 @@ namespace _Kits {
 #define ORM_FIELD_FROM_MAP(field) obj.field = map.at(#field).value<std::decay_t<decltype(obj.field)>>();
 #define ORM_FIELD_FROM_RECORD(field) obj.field = record.value(#field).value<std::decay_t<decltype(obj.field)>>();
 
+// 按位置读写：字段序号在编译期确定，热路径不构造中间 map、不按名字查找
+// 自增主键 id 不参与写入，写入列按字段声明顺序排列
+constexpr bool ormIsKey(std::string_view field) { return field == "id"; }
+// 时间字段默认不赋值（无效 QDateTime），写入时以同一批次的当前时间补齐，按原生时间戳绑定
+template <typename V> inline const V& ormStamped(const V& value, const QDateTime&) { return value; }
+inline QDateTime ormStamped(const QDateTime& value, const QDateTime& now) { return value.isValid() ? value : now; }
+template <typename V> inline void ormStamp(V&, const QDateTime&) {}
+inline void ormStamp(QDateTime& value, const QDateTime& now) { if (!value.isValid()) value = now; }
+#define ORM_FIELD_INDEX(field) field,
+#define ORM_FIELD_VALUE_COUNT(field) (ormIsKey(#field) ? 0 : 1) +
+#define ORM_FIELD_VALUE_NAME(field) if constexpr (!ormIsKey(#field)) names << QStringLiteral(#field);
+#define ORM_FIELD_TO_ROW(field) if constexpr (!ormIsKey(#field)) row.emplace_back(ormStamped(obj.field, now));
+#define ORM_FIELD_APPEND_COLUMN(field) if constexpr (!ormIsKey(#field)) columns[pos++].append(ormStamped(obj.field, now));
+#define ORM_FIELD_BIND(field) if constexpr (!ormIsKey(#field)) query.bindValue(pos++, ormStamped(obj.field, now));
+#define ORM_FIELD_STAMP(field) ormStamp(obj.field, now);
+#define ORM_FIELD_RESOLVE(field) columns[Index::field] = record.indexOf(QStringLiteral(#field));
+#define ORM_FIELD_FROM_QUERY(field) \
+    if (columns[Index::field] >= 0) obj.field = query.value(columns[Index::field]).value<std::decay_t<decltype(obj.field)>>();
+
 #define DECLARE_ORM_MAPPER(TYPE, FIELD_LIST) \
 template <> struct OrmMapper<TYPE> { \
     static std::unordered_map<std::string, QVariant> toMap(const TYPE& obj) { \
@@ -27,6 +53,46 @@ template <> struct OrmMapper<TYPE> { \
         FIELD_LIST(ORM_FIELD_FROM_RECORD) \
         return obj; \
     } \
+    /* 字段序号，如 OrmMapper<T>::Index::tag */ \
+    struct Index { enum : std::size_t { FIELD_LIST(ORM_FIELD_INDEX) count }; }; \
+    /* 写入列数（不含 id） */ \
+    static constexpr std::size_t valueCount = FIELD_LIST(ORM_FIELD_VALUE_COUNT) 0; \
+    /* 结果集中各字段的列号，-1 表示未查询该字段 */ \
+    using Columns = std::array<int, Index::count>; \
+    static const QStringList& valueColumns() { \
+        static const QStringList names = [] { QStringList names; FIELD_LIST(ORM_FIELD_VALUE_NAME) return names; }(); \
+        return names; \
+    } \
+    static std::vector<QVariant> toRow(const TYPE& obj, const QDateTime& now = QDateTime::currentDateTime()) { \
+        std::vector<QVariant> row; \
+        row.reserve(valueCount); \
+        FIELD_LIST(ORM_FIELD_TO_ROW) \
+        return row; \
+    } \
+    /* 批量写入：按列追加，columns 须有 valueCount 列 */ \
+    static void appendColumns(std::vector<QVariantList>& columns, const TYPE& obj, const QDateTime& now) { \
+        std::size_t pos = 0; \
+        FIELD_LIST(ORM_FIELD_APPEND_COLUMN) \
+    } \
+    static void bindValues(QSqlQuery& query, const TYPE& obj, const QDateTime& now) { \
+        int pos = 0; \
+        FIELD_LIST(ORM_FIELD_BIND) \
+    } \
+    /* 补齐未赋值的时间字段，用于延后写入的对象（如写后落库入队时） */ \
+    static void stamp(TYPE& obj, const QDateTime& now) { \
+        FIELD_LIST(ORM_FIELD_STAMP) \
+    } \
+    /* 每个结果集解析一次列号，逐行按列号取值 */ \
+    static Columns resolve(const QSqlRecord& record) { \
+        Columns columns; \
+        FIELD_LIST(ORM_FIELD_RESOLVE) \
+        return columns; \
+    } \
+    static TYPE fromQuery(const QSqlQuery& query, const Columns& columns) { \
+        TYPE obj; \
+        FIELD_LIST(ORM_FIELD_FROM_QUERY) \
+        return obj; \
+    } \
 };
 
 template <typename T>
@@ -71,6 +137,7 @@ DECLARE_ORM_MAPPER(location_data, LOCATION_DATA_FIELDS)
     F(location_id) \
     F(task_id) \
     F(points) \
+    F(points_bin) \
     F(created_time) \
     F(updated_time)
 
@@ -83,6 +150,7 @@ DECLARE_ORM_MAPPER(radar_data, RADAR_DATA_FIELDS)
     F(location_id_end) \
     F(task_id) \
     F(points) \
+    F(points_bin) \
     F(direction) \
     F(overrun_time) \
     F(point_count) \
@@ -8,8 +8,8 @@ struct device_status {
     int id = -1;
     QString tag = {};
     QString details_json = {};
-    QString created_time = QDateTime::currentDateTime().toString("yyyy-MM-dd HH:mm:ss.zzz");
-    QString updated_time = QDateTime::currentDateTime().toString("yyyy-MM-dd HH:mm:ss.zzz");
+    QDateTime created_time; // 未赋值时在写入时取当前时间
+    QDateTime updated_time;
     static QString tableName() { return "device_status"; }
 };
 
@@ -17,8 +17,8 @@ struct mvb_line_data {
     int id = -1;
     QString tag = {};
     QString details_json = {};
-    QString created_time = QDateTime::currentDateTime().toString("yyyy-MM-dd HH:mm:ss.zzz");
-    QString updated_time = QDateTime::currentDateTime().toString("yyyy-MM-dd HH:mm:ss.zzz");
+    QDateTime created_time; // 未赋值时在写入时取当前时间
+    QDateTime updated_time;
     static QString tableName() { return "mvb_line_data"; }
 };
 
@@ -29,8 +29,8 @@ struct location_data {
     QString pole_name = {};
     float train_move_dis = {};
     float speed = {};
-    QString created_time = QDateTime::currentDateTime().toString("yyyy-MM-dd HH:mm:ss.zzz");
-    QString updated_time = QDateTime::currentDateTime().toString("yyyy-MM-dd HH:mm:ss.zzz");
+    QDateTime created_time; // 未赋值时在写入时取当前时间
+    QDateTime updated_time;
     static QString tableName() { return "location_data"; }
 };
 
@@ -38,9 +38,10 @@ struct radar_data {
     int id = -1;
     int location_id = -1;
     int task_id = -1;
-    QString points = {};
-    QString created_time = QDateTime::currentDateTime().toString("yyyy-MM-dd HH:mm:ss.zzz");
-    QString updated_time = QDateTime::currentDateTime().toString("yyyy-MM-dd HH:mm:ss.zzz");
+    QString points = {}; // 旧格式 JSON 文本，迁移后为空
+    QByteArray points_bin = {}; // PointCloudCodec 编码的点云
+    QDateTime created_time; // 未赋值时在写入时取当前时间
+    QDateTime updated_time;
     static QString tableName() { return "radar_data"; }
 };
 
@@ -49,12 +50,13 @@ struct radar_over_data {
     int location_id_start = -1;
     int location_id_end = -1;
     int task_id = -1;
-    QString points = {};
+    QString points = {}; // 旧格式 JSON 文本，迁移后为空
+    QByteArray points_bin = {}; // PointCloudCodec 编码的点云
     QString direction = {};
     int overrun_time = -1;
     int point_count = -1;
-    QString created_time = QDateTime::currentDateTime().toString("yyyy-MM-dd HH:mm:ss.zzz");
-    QString updated_time = QDateTime::currentDateTime().toString("yyyy-MM-dd HH:mm:ss.zzz");
+    QDateTime created_time; // 未赋值时在写入时取当前时间
+    QDateTime updated_time;
     static QString tableName() { return "radar_over_data"; }
 };
 
@@ -67,8 +69,8 @@ struct task_data {
     QString start_station = {};
     QString end_station = {};
     QString start_pole = {};
-    QString created_time = QDateTime::currentDateTime().toString("yyyy-MM-dd HH:mm:ss.zzz");
-    QString updated_time = QDateTime::currentDateTime().toString("yyyy-MM-dd HH:mm:ss.zzz");
+    QDateTime created_time; // 未赋值时在写入时取当前时间
+    QDateTime updated_time;
     static QString tableName() { return "task_data"; }
 };
 
@@ -81,8 +83,8 @@ struct line_data {
     float kilo_meter = {};
     QString pole_name = {};
     int line_dir = -1;
-    QString created_time = QDateTime::currentDateTime().toString("yyyy-MM-dd HH:mm:ss.zzz");
-    QString updated_time = QDateTime::currentDateTime().toString("yyyy-MM-dd HH:mm:ss.zzz");
+    QDateTime created_time; // 未赋值时在写入时取当前时间
+    QDateTime updated_time;
     static QString tableName() { return "line_data"; }
 };
 
@@ -93,8 +95,8 @@ struct arc_data {
     int arc_pulse = -1;
     qint64 arc_timestamp = {};
     QString arcvideo_path = {};
-    QString created_time = QDateTime::currentDateTime().toString("yyyy-MM-dd HH:mm:ss.zzz");
-    QString updated_time = QDateTime::currentDateTime().toString("yyyy-MM-dd HH:mm:ss.zzz");
+    QDateTime created_time; // 未赋值时在写入时取当前时间
+    QDateTime updated_time;
     static QString tableName() { return "arc_data"; }
 };
 
@@ -0,0 +1,312 @@
+#include "ConfigService.h"
+#include "kits/required/log/CRossLogger.h"
+#include <QFileSystemWatcher>
+#include <QTimer>
+#include <cstdio>
+#include <filesystem>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#endif
+
+namespace _Kits
+{
+    static std::string executableDirectory()
+    {
+#ifdef _WIN32
+        wchar_t buffer[MAX_PATH] = {0};
+        if (GetModuleFileNameW(nullptr, buffer, MAX_PATH) > 0)
+        {
+            return std::filesystem::path(buffer).parent_path().string();
+        }
+#else
+        std::error_code ec;
+        auto exe = std::filesystem::read_symlink("/proc/self/exe", ec);
+        if (!ec)
+        {
+            return exe.parent_path().string();
+        }
+#endif
+        return std::filesystem::current_path().string();
+    }
+
+    // 取子节点，缺失的段返回空节点，避免对不存在的节点继续取下标时抛出 InvalidNode
+    static YAML::Node section(const YAML::Node &node, const char *key)
+    {
+        if (node.IsDefined() && node.IsMap() && node[key])
+        {
+            return node[key];
+        }
+        return YAML::Node();
+    }
+
+    ConfigService::ConfigService()
+        : m_appDirectory(executableDirectory()),
+          m_configPath(m_appDirectory + "/config/config.yaml")
+    {
+        // 日志系统依赖本服务初始化，此处不能使用 LogXxx
+        auto snapshot = parse(1);
+        if (!snapshot->valid)
+        {
+            std::fprintf(stderr, "ConfigService: failed to load %s\n", m_configPath.c_str());
+        }
+        m_snapshot = std::move(snapshot);
+    }
+
+    ConfigService::~ConfigService()
+    {
+    }
+
+    std::shared_ptr<ConfigSnapshot> ConfigService::parse(uint64_t version) const
+    {
+        auto snapshot = std::make_shared<ConfigSnapshot>();
+        snapshot->version = version;
+        try
+        {
+            snapshot->root = YAML::LoadFile(m_configPath);
+            const auto &root = snapshot->root;
+
+            const auto app = section(root, "app");
+            if (app["save_path"])
+            {
+                snapshot->savePath = app["save_path"].as<std::string>();
+            }
+            if (app["bench_routes"])
+            {
+                snapshot->benchRoutes = app["bench_routes"].as<bool>();
+            }
+
+            const auto log = section(root, "log");
+            if (app["save_path"] && log["log_level"])
+            {
+                snapshot->log.rootPath = snapshot->savePath + "/log/";
+                snapshot->log.level = log["log_level"].as<std::string>();
+            }
+            if (log["sync_policy"])
+            {
+                snapshot->log.syncPolicy = log["sync_policy"].as<std::string>();
+            }
+            if (log["json_sink"])
+            {
+                snapshot->log.jsonSink = log["json_sink"].as<bool>();
+            }
+            if (log["flight_recorder"])
+            {
+                snapshot->log.flightRecorder = log["flight_recorder"].as<bool>();
+            }
+            if (log["flight_slots"])
+            {
+                snapshot->log.flightSlots = log["flight_slots"].as<std::size_t>();
+            }
+
+            const auto db = section(root, "database");
+            if (db["rdbms"] && db["host"] && db["port"] && db["db_name"] && db["user"])
+            {
+                snapshot->database.rdbms = db["rdbms"].as<std::string>();
+                snapshot->database.host = db["host"].as<std::string>();
+                snapshot->database.port = static_cast<uint16_t>(db["port"].as<int>());
+                snapshot->database.dbName = db["db_name"].as<std::string>();
+                snapshot->database.user = db["user"].as<std::string>();
+                snapshot->database.valid = true;
+            }
+            if (db["max_connections"])
+            {
+                snapshot->database.maxConnections = db["max_connections"].as<int>();
+            }
+            if (db["wait_timeout_ms"])
+            {
+                snapshot->database.waitTimeoutMs = db["wait_timeout_ms"].as<int>();
+            }
+            if (db["idle_timeout_ms"])
+            {
+                snapshot->database.idleTimeoutMs = db["idle_timeout_ms"].as<int>();
+            }
+            if (db["validate_idle_ms"])
+            {
+                snapshot->database.validateIdleMs = db["validate_idle_ms"].as<int>();
+            }
+            if (db["executor_threads"])
+            {
+                snapshot->database.executorThreads = db["executor_threads"].as<int>();
+            }
+            if (db["statement_cache_size"])
+            {
+                snapshot->database.statementCacheSize = db["statement_cache_size"].as<int>();
+            }
+            const auto writeBehind = section(db, "write_behind");
+            if (writeBehind["batch_size"])
+            {
+                snapshot->database.writeBatchSize = writeBehind["batch_size"].as<int>();
+            }
+            if (writeBehind["flush_interval_ms"])
+            {
+                snapshot->database.writeFlushIntervalMs = writeBehind["flush_interval_ms"].as<int>();
+            }
+            if (writeBehind["max_pending_rows"])
+            {
+                snapshot->database.writeMaxPendingRows = writeBehind["max_pending_rows"].as<int>();
+            }
+            if (writeBehind["backpressure_ms"])
+            {
+                snapshot->database.writeBackpressureMs = writeBehind["backpressure_ms"].as<int>();
+            }
+            if (writeBehind["replay_batch_size"])
+            {
+                snapshot->database.writeReplayBatchSize = writeBehind["replay_batch_size"].as<int>();
+            }
+            const auto resultCache = section(db, "result_cache");
+            if (resultCache["memory_mb"])
+            {
+                snapshot->database.resultCacheMb = resultCache["memory_mb"].as<int>();
+            }
+            if (resultCache["ttl_ms"])
+            {
+                snapshot->database.resultCacheTtlMs = resultCache["ttl_ms"].as<int>();
+            }
+            const auto deviceStatus = section(db, "device_status");
+            if (deviceStatus["keyframe_ms"])
+            {
+                snapshot->database.deviceStatusKeyframeMs = deviceStatus["keyframe_ms"].as<int>();
+            }
+            if (db["partition_maintain_minutes"])
+            {
+                snapshot->database.partitionMaintainMinutes = db["partition_maintain_minutes"].as<int>();
+            }
+            const auto partitions = section(db, "partitions");
+            for (std::size_t i = 0; partitions.IsSequence() && i < partitions.size(); ++i)
+            {
+                const auto item = partitions[i];
+                if (!item.IsMap() || !item["table"])
+                {
+                    continue;
+                }
+                PartitionPolicy policy;
+                policy.table = item["table"].as<std::string>();
+                if (item["column"])
+                {
+                    policy.column = item["column"].as<std::string>();
+                }
+                if (item["interval"])
+                {
+                    policy.interval = item["interval"].as<std::string>();
+                }
+                if (item["premake"])
+                {
+                    policy.premake = item["premake"].as<int>();
+                }
+                if (item["retain_days"])
+                {
+                    policy.retainDays = item["retain_days"].as<int>();
+                }
+                if (item["retention"])
+                {
+                    policy.detach = item["retention"].as<std::string>() == "detach";
+                }
+                snapshot->database.partitions.push_back(std::move(policy));
+            }
+            snapshot->valid = snapshot->root.IsMap();
+        }
+        catch (const YAML::Exception &e)
+        {
+            std::fprintf(stderr, "ConfigService: %s\n", e.what());
+            snapshot->valid = false;
+        }
+        return snapshot;
+    }
+
+    bool ConfigService::loadFile(const std::string &relativePath, YAML::Node &node)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_fileCache.find(relativePath);
+        if (it == m_fileCache.end())
+        {
+            try
+            {
+                it = m_fileCache.emplace(relativePath, YAML::LoadFile(m_appDirectory + relativePath)).first;
+            }
+            catch (const std::exception &e)
+            {
+                LogError("Failed to load config file {}: {}", relativePath, e.what());
+                return false;
+            }
+        }
+        // YAML::Node 是引用语义，返回副本避免调用方修改缓存
+        node = YAML::Clone(it->second);
+        return true;
+    }
+
+    int ConfigService::subscribe(Listener &&listener)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        int id = ++m_nextListenerId;
+        m_listeners.emplace(id, std::move(listener));
+        return id;
+    }
+
+    void ConfigService::unsubscribe(int id)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_listeners.erase(id);
+    }
+
+    void ConfigService::watch()
+    {
+        if (m_watcher != nullptr)
+        {
+            return;
+        }
+        m_watcher = new QFileSystemWatcher(this);
+        m_debounce = new QTimer(this);
+        m_debounce->setSingleShot(true);
+        m_debounce->setInterval(200);
+        connect(m_debounce, &QTimer::timeout, this, [this]() { reload(); });
+        // 编辑器通常以“写临时文件 + 重命名”的方式保存，同时监视目录以捕获替换
+        auto file = QString::fromStdString(m_configPath);
+        m_watcher->addPath(file);
+        m_watcher->addPath(QString::fromStdString(std::filesystem::path(m_configPath).parent_path().string()));
+        connect(m_watcher, &QFileSystemWatcher::fileChanged, this, [this]() { onFileChanged(); });
+        connect(m_watcher, &QFileSystemWatcher::directoryChanged, this, [this]() { onFileChanged(); });
+    }
+
+    void ConfigService::onFileChanged()
+    {
+        // 文件被替换后原监视失效，重新加入
+        auto file = QString::fromStdString(m_configPath);
+        if (!m_watcher->files().contains(file) && std::filesystem::exists(m_configPath))
+        {
+            m_watcher->addPath(file);
+        }
+        m_debounce->start();
+    }
+
+    bool ConfigService::reload()
+    {
+        auto current = snapshot();
+        auto next = parse(current->version + 1);
+        if (!next->valid)
+        {
+            LogWarn("Config reload failed, keep version {}", current->version);
+            return false;
+        }
+        std::shared_ptr<const ConfigSnapshot> published = next;
+        std::atomic_store(&m_snapshot, published);
+
+        std::vector<Listener> listeners;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_fileCache.clear();
+            listeners.reserve(m_listeners.size());
+            for (const auto &it : m_listeners)
+            {
+                listeners.push_back(it.second);
+            }
+        }
+        LogInfo("Config reloaded, version {}", published->version);
+        for (const auto &listener : listeners)
+        {
+            listener(*published);
+        }
+        return true;
+    }
+} // namespace _Kits
@@ -0,0 +1,151 @@
+#pragma once
+#include <QObject>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <qtmetamacros.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <yaml-cpp/yaml.h>
+
+class QFileSystemWatcher;
+class QTimer;
+
+namespace _Kits
+{
+struct LogConfig
+{
+    std::string level = "debug";
+    std::string rootPath = "/log/"; // 日志根目录，以 / 结尾
+    std::string syncPolicy = "rotate";
+    bool jsonSink = false;
+    bool flightRecorder = true;
+    std::size_t flightSlots = 16384;
+};
+
+// database.partitions 中的一项：按时间范围分区的表及其保留策略（仅 PostgreSQL）
+struct PartitionPolicy
+{
+    std::string table;
+    std::string column = "created_time"; // 分区键
+    std::string interval = "day";        // day | month
+    int premake = 3;                     // 提前创建的分区个数（含当前）
+    int retainDays = 0;                  // 保留天数，0 表示不清理
+    bool detach = false;                 // 过期分区只分离不删除（retention: detach）
+};
+
+struct DatabaseConfig
+{
+    bool valid = false; // rdbms/host/port/db_name/user 是否齐全
+    std::string rdbms;
+    std::string host;
+    uint16_t port = 0;
+    std::string dbName;
+    std::string user;
+    // 连接池参数，支持热更新
+    int maxConnections = 16;
+    int waitTimeoutMs = 5000;
+    int idleTimeoutMs = 60000;
+    int validateIdleMs = 5000;
+    int executorThreads = 4; // DatabaseExecutor 线程数（每个线程占用一条连接）
+    int statementCacheSize = 64; // 每条连接缓存的预编译语句数，0 表示不缓存
+    // database.write_behind：写后落库的攒批参数
+    int writeBatchSize = 500;
+    int writeFlushIntervalMs = 200;
+    int writeMaxPendingRows = 50000;
+    int writeBackpressureMs = 50;
+    int writeReplayBatchSize = 5000; // 日志补写单批行数（PostgreSQL 以 COPY 写入）
+    // database.result_cache：查询结果缓存
+    int resultCacheMb = 16;
+    int resultCacheTtlMs = 30000;
+    // database.device_status：设备状态只在变化时写库，值不变时每隔 keyframe_ms 补写一行
+    int deviceStatusKeyframeMs = 600000;
+    std::vector<PartitionPolicy> partitions;
+    int partitionMaintainMinutes = 60; // 分区维护周期
+};
+
+/**
+ * @brief 一次解析得到的只读配置快照。
+ *
+ * 发布后不再修改，多线程可直接读取；热更新时整体替换为新快照。
+ */
+struct ConfigSnapshot
+{
+    uint64_t version = 0; // 每次成功加载递增
+    bool valid = false;   // config.yaml 是否解析成功
+    YAML::Node root;      // 完整配置树，按模块名分块；只做 const 访问，需要可修改的树时用 YAML::Clone
+    std::string savePath; // app.save_path
+    bool benchRoutes = false; // app.bench_routes：开放 /database/bench 等压测路由（写入数据、占满连接），仅限本机访问
+    LogConfig log;
+    DatabaseConfig database;
+};
+
+/**
+ * @brief 配置服务：启动时解析一次 config/config.yaml，对外提供不可变快照。
+ *
+ * - 路径相对于可执行文件所在目录，不依赖进程工作目录。
+ * - snapshot() 只做一次原子指针加载，可在热路径调用。
+ * - watch() 后监视配置文件（Linux 下为 inotify），变更时重新解析并原子替换快照，
+ *   再通知通过 subscribe() 订阅热更新的模块；解析失败时保留旧快照。
+ * - loadFile() 读取模块引用的子配置文件，解析结果缓存，配置变更时失效。
+ */
+class ConfigService : public QObject
+{
+    Q_OBJECT
+  public:
+    using Listener = std::function<void(const ConfigSnapshot &)>;
+
+    static ConfigService &instance()
+    {
+        static ConfigService service;
+        return service;
+    }
+    virtual ~ConfigService();
+
+    std::shared_ptr<const ConfigSnapshot> snapshot() const
+    {
+        return std::atomic_load(&m_snapshot);
+    }
+    const std::string &appDirectory() const
+    {
+        return m_appDirectory;
+    }
+    const std::string &configPath() const
+    {
+        return m_configPath;
+    }
+
+    /// @brief 读取相对于可执行文件目录的 YAML 文件，解析结果缓存
+    bool loadFile(const std::string &relativePath, YAML::Node &node);
+
+    /// @brief 订阅热更新，回调在主线程执行；返回订阅 id
+    int subscribe(Listener &&listener);
+    void unsubscribe(int id);
+
+    /// @brief 开始监视配置文件，需在 QCoreApplication 创建之后调用
+    void watch();
+    bool reload();
+
+  protected:
+    ConfigService();
+    ConfigService(const ConfigService &) = delete;
+    ConfigService &operator=(const ConfigService &) = delete;
+
+  private:
+    std::shared_ptr<ConfigSnapshot> parse(uint64_t version) const;
+    void onFileChanged();
+
+    std::string m_appDirectory;
+    std::string m_configPath;
+    std::shared_ptr<const ConfigSnapshot> m_snapshot;
+    std::mutex m_mutex; // 保护子配置缓存与订阅表
+    std::unordered_map<std::string, YAML::Node> m_fileCache;
+    std::unordered_map<int, Listener> m_listeners;
+    int m_nextListenerId = 0;
+    QFileSystemWatcher *m_watcher = nullptr;
+    QTimer *m_debounce = nullptr; // 合并编辑器保存时的多次变更通知
+};
+} // namespace _Kits
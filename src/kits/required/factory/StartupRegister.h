@@ -0,0 +1,82 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace _Kits
+{
+    // 启动钩子与启动指标：kit 注册需要在框架启动时执行的初始化，框架在 QApplication 创建、配置加载后统一触发
+    class StartupRegister
+    {
+      public:
+        using Clock = std::chrono::steady_clock;
+
+        static void registerHook(const std::string &name, std::function<void()> hook)
+        {
+            std::lock_guard locker(mutex());
+            hooks().emplace_back(name, std::move(hook));
+        }
+
+        /// @brief 按注册顺序执行全部钩子，只执行一次；钩子应尽快返回，耗时工作放到自己的线程
+        static void runAll()
+        {
+            std::vector<std::pair<std::string, std::function<void()>>> pending;
+            {
+                std::lock_guard locker(mutex());
+                pending.swap(hooks());
+            }
+            for (auto &[name, hook] : pending)
+            {
+                hook();
+            }
+        }
+
+        /// @brief 记录启动里程碑，值为距进程启动的毫秒数
+        static int64_t mark(const std::string &milestone)
+        {
+            const auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - m_processStart).count();
+            std::lock_guard locker(mutex());
+            milestones().emplace_back(milestone, ms);
+            return ms;
+        }
+
+        static std::vector<std::pair<std::string, int64_t>> getMilestones()
+        {
+            std::lock_guard locker(mutex());
+            return milestones();
+        }
+
+      private:
+        static std::mutex &mutex()
+        {
+            static std::mutex mutex;
+            return mutex;
+        }
+        static std::vector<std::pair<std::string, std::function<void()>>> &hooks()
+        {
+            static auto hooks = std::vector<std::pair<std::string, std::function<void()>>>();
+            return hooks;
+        }
+        static std::vector<std::pair<std::string, int64_t>> &milestones()
+        {
+            static auto milestones = std::vector<std::pair<std::string, int64_t>>();
+            return milestones;
+        }
+
+        inline static const Clock::time_point m_processStart = Clock::now(); // 静态初始化时刻，近似进程启动
+    };
+
+} // namespace _Kits
+// 注册启动钩子，在框架启动时执行
+#define DECLARE_STARTUP(name, func)                                                                                                        \
+    namespace                                                                                                                              \
+    {                                                                                                                                      \
+        const bool startupRegistered_ = []() {                                                                                             \
+            _Kits::StartupRegister::registerHook(name, func);                                                                              \
+            return true;                                                                                                                   \
+        }();                                                                                                                               \
+    }
@@ -1,9 +1,12 @@
 #include "CRossLogger.h"
+#include "FlightRecorderSink.h"
+#include "JsonSegmentSink.h"
 #include "PlainTextSink.h"
+#include "QtMessageBridge.h"
+#include "kits/required/config/ConfigService.h"
 #include "spdlog/sinks/stdout_color_sinks.h"
 #include <filesystem>
 #include <qlogging.h>
-#include <yaml-cpp/yaml.h>
 
 namespace _Kits
 {
@@ -41,6 +44,19 @@ namespace _Kits
         // 默认级别为 info
         return spdlog::level::info;
     }
+    static LogSyncPolicy getSyncPolicyFromString(std::string_view policy)
+    {
+        if (policy == "never")
+        {
+            return LogSyncPolicy::never;
+        }
+        else if (policy == "flush")
+        {
+            return LogSyncPolicy::on_flush;
+        }
+        // 默认在文件切换时落盘
+        return LogSyncPolicy::on_rotate;
+    }
     spdlog::source_loc CRossLogger::getLogSourceLocation(
         const SourceLocation &location)
     {
@@ -58,20 +74,10 @@ namespace _Kits
 
     bool CRossLogger::initLogger()
     {
-        std::string strfilePath =
-            std::filesystem::current_path().string() + "/config/config.yaml";
-        auto config = YAML::LoadFile(strfilePath);
+        auto config = ConfigService::instance().snapshot();
         // 初始化日志记录器
 
-        std::string strRootPath = "/log/";
-        std::string strLogLevel = "debug";
-
-        if (config["app"]["save_path"] && config["log"]["log_level"])
-        {
-            strRootPath =
-                config["app"]["save_path"].as<std::string>() + "/log/";
-            strLogLevel = config["log"]["log_level"].as<std::string>();
-        }
+        const std::string &strRootPath = config->log.rootPath;
 
         std::filesystem::path logPath(strRootPath);
         std::filesystem::path directory = logPath.parent_path();
@@ -87,8 +93,10 @@ namespace _Kits
         size_t maxFileSize = 50;
         std::string_view pattern = getDefaultLogPattern();
         auto fileSink = std::make_shared<PlainTextSink_mt>(
-            std::string(strRootPath), maxFileSize * 1024 * 1024);
-        m_level = getLogLevelFromString(strLogLevel);
+            std::string(strRootPath),
+            maxFileSize * 1024 * 1024,
+            getSyncPolicyFromString(config->log.syncPolicy));
+        m_level = getLogLevelFromString(config->log.level);
         fileSink->set_level(m_level);
         fileSink->set_pattern(std::string(pattern));
 
@@ -98,11 +106,52 @@ namespace _Kits
         consoleSink->set_pattern(std::string(pattern));
 
         std::vector<spdlog::sink_ptr> sinks{fileSink, consoleSink};
+        // 可选的结构化日志，按时间索引分段存储，供 /log/query 查询
+        if (config->log.jsonSink)
+        {
+            m_jsonDirectory = strRootPath + "json";
+            auto jsonSink = std::make_shared<JsonSegmentSink_mt>(m_jsonDirectory);
+            jsonSink->set_level(m_level);
+            sinks.push_back(jsonSink);
+        }
+        // 飞行记录器：崩溃后可用 flight_reader 读取最后的日志与框架事件
+        if (config->log.flightRecorder)
+        {
+            if (FlightRecorder::instance().open(strRootPath + "flight.rec", config->log.flightSlots))
+            {
+                auto flightSink = std::make_shared<FlightRecorderSink>();
+                flightSink->set_level(m_level);
+                sinks.push_back(flightSink);
+            }
+        }
         m_logger = std::make_shared<spdlog::logger>(
             "CRossLogger", std::begin(sinks), std::end(sinks));
         m_logger->set_level(m_level);
+        // 文件 sink 使用用户态缓冲，告警以上立即刷出，其余每秒刷出一次
+        m_logger->flush_on(spdlog::level::warn);
+        spdlog::flush_every(std::chrono::seconds(1));
 
         spdlog::set_default_logger(m_logger);
+
+        // 配置热更新时只调整日志级别，sink 与目录需重启生效
+        ConfigService::instance().subscribe([this](const ConfigSnapshot &snapshot) {
+            setLogLevel(getLogLevelFromString(snapshot.log.level));
+        });
         return true;
     }
+
+    void CRossLogger::setLogLevel(spdlog::level::level_enum level)
+    {
+        if (m_level.exchange(level) == level)
+        {
+            return;
+        }
+        for (const auto &sink : m_logger->sinks())
+        {
+            sink->set_level(level);
+        }
+        m_logger->set_level(level);
+        QtMessageBridge::refreshCategories();
+        spdlog::info("Log level changed to {}", spdlog::level::to_string_view(level));
+    }
 } // namespace _Kits
\ No newline at end of file
@@ -2,6 +2,7 @@
 
 #include "SourceLocation.h"
 #include "spdlog/spdlog.h"
+#include <atomic>
 #include <fmt/format.h>
 #include <spdlog/common.h>
 #include <spdlog/sinks/rotating_file_sink.h>
@@ -26,10 +27,17 @@ class CRossLogger final
     std::string_view getDefaultLogPattern();
     spdlog::source_loc getLogSourceLocation(const SourceLocation &location);
     bool initLogger();
+    /// @brief 运行时调整日志级别（配置热更新时调用）
+    void setLogLevel(spdlog::level::level_enum level);
     int getLogLevel()
     {
         return m_level;
     }
+    // 结构化日志目录，未启用 json_sink 时为空
+    const std::string &getJsonLogDirectory() const
+    {
+        return m_jsonDirectory;
+    }
 
   protected:
     CRossLogger()
@@ -38,8 +46,9 @@ class CRossLogger final
     }
 
   private:
-    spdlog::level::level_enum m_level;
+    std::atomic<spdlog::level::level_enum> m_level{spdlog::level::info};
     std::shared_ptr<spdlog::logger> m_logger;
+    std::string m_jsonDirectory;
 };
 
 // trace
@@ -0,0 +1,175 @@
+#include "FlightRecorder.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <new>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace _Kits
+{
+    namespace
+    {
+        uint64_t currentThreadId() noexcept
+        {
+            thread_local const uint64_t tid =
+#ifdef _WIN32
+                static_cast<uint64_t>(::GetCurrentThreadId());
+#else
+                static_cast<uint64_t>(::syscall(SYS_gettid));
+#endif
+            return tid;
+        }
+
+        int64_t nowUs() noexcept
+        {
+            return std::chrono::duration_cast<std::chrono::microseconds>(
+                       std::chrono::system_clock::now().time_since_epoch())
+                .count();
+        }
+
+        int64_t currentPid() noexcept
+        {
+#ifdef _WIN32
+            return static_cast<int64_t>(::GetCurrentProcessId());
+#else
+            return static_cast<int64_t>(::getpid());
+#endif
+        }
+    } // namespace
+
+    FlightRecorder::~FlightRecorder()
+    {
+        close();
+    }
+
+    bool FlightRecorder::open(const std::string &filePath, std::size_t slotCount)
+    {
+        if (m_header != nullptr || slotCount == 0)
+        {
+            return false;
+        }
+        // 保留上一次运行（可能是崩溃）留下的记录
+        std::error_code ec;
+        if (std::filesystem::exists(filePath, ec))
+        {
+            std::filesystem::rename(filePath, filePath + ".prev", ec);
+        }
+        std::filesystem::create_directories(std::filesystem::path(filePath).parent_path(), ec);
+
+        const std::size_t size = sizeof(FlightHeader) + slotCount * sizeof(FlightSlot);
+        void *base = nullptr;
+#ifdef _WIN32
+        HANDLE file = ::CreateFileA(filePath.c_str(),
+                                    GENERIC_READ | GENERIC_WRITE,
+                                    FILE_SHARE_READ,
+                                    nullptr,
+                                    CREATE_ALWAYS,
+                                    FILE_ATTRIBUTE_NORMAL,
+                                    nullptr);
+        if (file == INVALID_HANDLE_VALUE)
+        {
+            return false;
+        }
+        HANDLE mapping = ::CreateFileMappingA(file,
+                                              nullptr,
+                                              PAGE_READWRITE,
+                                              static_cast<DWORD>(static_cast<uint64_t>(size) >> 32),
+                                              static_cast<DWORD>(size & 0xFFFFFFFFu),
+                                              nullptr);
+        ::CloseHandle(file); // 映射对象持有文件引用
+        if (mapping == nullptr)
+        {
+            return false;
+        }
+        base = ::MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, size);
+        if (base == nullptr)
+        {
+            ::CloseHandle(mapping);
+            return false;
+        }
+        m_mapping = mapping;
+#else
+        int fd = ::open(filePath.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0)
+        {
+            return false;
+        }
+        if (::ftruncate(fd, static_cast<off_t>(size)) != 0)
+        {
+            ::close(fd);
+            return false;
+        }
+        base = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        ::close(fd); // 映射建立后即可关闭描述符
+        if (base == MAP_FAILED)
+        {
+            return false;
+        }
+#endif
+        std::memset(base, 0, size);
+        auto *header = new (base) FlightHeader{};
+        header->magic = kFlightMagic;
+        header->version = kFlightVersion;
+        header->slotSize = kFlightSlotSize;
+        header->slotCount = static_cast<uint32_t>(slotCount);
+        header->pid = currentPid();
+        header->startUs = nowUs();
+        header->next.store(0, std::memory_order_relaxed);
+
+        m_slots = reinterpret_cast<FlightSlot *>(static_cast<char *>(base) + sizeof(FlightHeader));
+        m_slotCount = slotCount;
+        m_mappedSize = size;
+        std::atomic_thread_fence(std::memory_order_release);
+        m_header = header;
+        return true;
+    }
+
+    void FlightRecorder::close()
+    {
+        if (m_header == nullptr)
+        {
+            return;
+        }
+        void *base = m_header;
+        m_header = nullptr;
+        m_slots = nullptr;
+#ifdef _WIN32
+        ::FlushViewOfFile(base, m_mappedSize);
+        ::UnmapViewOfFile(base);
+        ::CloseHandle(static_cast<HANDLE>(m_mapping));
+        m_mapping = nullptr;
+#else
+        ::munmap(base, m_mappedSize);
+#endif
+        m_mappedSize = 0;
+    }
+
+    void FlightRecorder::commit(FlightKind kind, uint8_t level, std::string_view text) noexcept
+    {
+        const uint64_t seq = m_header->next.fetch_add(1, std::memory_order_relaxed);
+        FlightSlot &slot = m_slots[seq % m_slotCount];
+        slot.seq.store(0, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        const auto length = std::min(text.size(), sizeof(slot.text));
+        slot.tsUs = nowUs();
+        slot.thread = currentThreadId();
+        slot.kind = static_cast<uint8_t>(kind);
+        slot.level = level;
+        slot.length = static_cast<uint16_t>(length);
+        std::memcpy(slot.text, text.data(), length);
+        slot.seq.store(seq + 1, std::memory_order_release);
+    }
+} // namespace _Kits
@@ -0,0 +1,62 @@
+#pragma once
+#include "FlightRecorderLayout.h"
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace _Kits
+{
+/**
+ * @brief 进程崩溃后仍可读取的飞行记录器。
+ *
+ * 固定大小的环形缓冲映射到磁盘文件（mmap / 文件映射），写入只是一次原子自增加
+ * 一次内存拷贝，不经过系统调用；进程异常退出时内容由操作系统保留在文件中。
+ * 使用 tools/flight_reader 读取崩溃进程留下的记录文件。
+ *
+ * 每次启动时已存在的记录文件会被重命名为 *.prev，避免覆盖上一次崩溃的现场。
+ */
+class FlightRecorder
+{
+  public:
+    static FlightRecorder &instance()
+    {
+        static FlightRecorder recorder;
+        return recorder;
+    }
+    ~FlightRecorder();
+
+    bool open(const std::string &filePath, std::size_t slotCount = 16384);
+    void close();
+    bool isOpen() const
+    {
+        return m_header != nullptr;
+    }
+    void write(FlightKind kind, uint8_t level, std::string_view text) noexcept
+    {
+        if (m_header != nullptr)
+        {
+            commit(kind, level, text);
+        }
+    }
+
+  protected:
+    FlightRecorder() = default;
+    FlightRecorder(const FlightRecorder &) = delete;
+    FlightRecorder &operator=(const FlightRecorder &) = delete;
+
+  private:
+    void commit(FlightKind kind, uint8_t level, std::string_view text) noexcept;
+
+    FlightHeader *m_header = nullptr;
+    FlightSlot *m_slots = nullptr;
+    std::size_t m_slotCount = 0;
+    std::size_t m_mappedSize = 0;
+    void *m_mapping = nullptr; // Windows 文件映射句柄
+};
+
+/// @brief 记录框架事件（模块调用、数据库操作、网络事件等），未启用时仅一次判空
+inline void flightEvent(FlightKind kind, std::string_view text) noexcept
+{
+    FlightRecorder::instance().write(kind, 0, text);
+}
+} // namespace _Kits
@@ -0,0 +1,47 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+
+// 飞行记录器环形缓冲的文件布局，写入端（FlightRecorder）与离线读取工具共用。
+// 仅依赖标准库，修改布局时必须同步提升 kFlightVersion。
+namespace _Kits
+{
+constexpr uint32_t kFlightMagic = 0x52464954; // "TIFR"
+constexpr uint32_t kFlightVersion = 1;
+constexpr uint32_t kFlightSlotSize = 256;
+
+enum class FlightKind : uint8_t
+{
+    log = 0,      // 日志记录
+    invoke = 1,   // 模块调用
+    database = 2, // 数据库操作
+    socket = 3    // 网络连接事件
+};
+
+struct alignas(64) FlightHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t slotSize;
+    uint32_t slotCount;
+    int64_t pid;
+    int64_t startUs;               // 进程启动时间（epoch 微秒）
+    std::atomic<uint64_t> next;    // 下一条记录的序号
+};
+
+struct FlightSlot
+{
+    std::atomic<uint64_t> seq; // 提交标记：序号 + 1，写入中为 0
+    int64_t tsUs;              // 记录时间（epoch 微秒）
+    uint64_t thread;           // 线程 id
+    uint8_t kind;              // FlightKind
+    uint8_t level;             // 日志级别（spdlog::level），事件为 0
+    uint16_t length;           // text 有效字节数
+    uint32_t reserved;
+    char text[kFlightSlotSize - 32];
+};
+
+static_assert(sizeof(FlightHeader) == 64, "flight header layout changed");
+static_assert(sizeof(FlightSlot) == kFlightSlotSize, "flight slot layout changed");
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "flight ring requires lock-free 64-bit atomics");
+} // namespace _Kits
@@ -0,0 +1,43 @@
+#pragma once
+#include "FlightRecorder.h"
+#include <algorithm>
+#include <cstring>
+#include <spdlog/details/null_mutex.h>
+#include <spdlog/sinks/base_sink.h>
+
+namespace _Kits
+{
+/**
+ * @brief 将日志原文写入飞行记录器。
+ *
+ * 不经过 formatter，只记录 "文件名:行号 消息"，记录器本身无锁，因此使用 null_mutex。
+ */
+class FlightRecorderSink final : public spdlog::sinks::base_sink<spdlog::details::null_mutex>
+{
+  protected:
+    void sink_it_(const spdlog::details::log_msg &msg) override
+    {
+        char text[sizeof(FlightSlot::text)];
+        std::size_t length = 0;
+        if (!msg.source.empty())
+        {
+            std::string_view file(msg.source.filename);
+            auto pos = file.find_last_of("/\\");
+            if (pos != std::string_view::npos)
+            {
+                file.remove_prefix(pos + 1);
+            }
+            auto result = spdlog::fmt_lib::format_to_n(text, sizeof(text), "{}:{} ", file, msg.source.line);
+            length = std::min(result.size, sizeof(text));
+        }
+        auto payload = std::min(msg.payload.size(), sizeof(text) - length);
+        std::memcpy(text + length, msg.payload.data(), payload);
+        FlightRecorder::instance().write(
+            FlightKind::log, static_cast<uint8_t>(msg.level), std::string_view(text, length + payload));
+    }
+
+    void flush_() override
+    {
+    }
+};
+} // namespace _Kits
@@ -0,0 +1,200 @@
+#include "JsonLogQuery.h"
+#include "JsonSegmentSink.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <filesystem>
+#include <string_view>
+
+namespace _Kits
+{
+    namespace
+    {
+        bool seekTo(std::FILE *fp, uint64_t offset)
+        {
+#ifdef _WIN32
+            return _fseeki64(fp, static_cast<__int64>(offset), SEEK_SET) == 0;
+#else
+            return fseeko(fp, static_cast<off_t>(offset), SEEK_SET) == 0;
+#endif
+        }
+
+        uint32_t levelMaskFrom(spdlog::level::level_enum minLevel)
+        {
+            uint32_t mask = 0;
+            for (int lv = minLevel; lv < spdlog::level::off; ++lv)
+            {
+                mask |= 1u << lv;
+            }
+            return mask;
+        }
+
+        // 行首固定为 {"ts":<num>,"level":"<name>"，只解析这两个字段
+        bool parseHead(std::string_view line, int64_t &ts, spdlog::level::level_enum &level)
+        {
+            constexpr std::string_view tsKey = "{\"ts\":";
+            constexpr std::string_view levelKey = ",\"level\":\"";
+            if (line.substr(0, tsKey.size()) != tsKey)
+            {
+                return false;
+            }
+            char *end = nullptr;
+            ts = std::strtoll(line.data() + tsKey.size(), &end, 10);
+            std::string_view rest(end, line.size() - (end - line.data()));
+            if (rest.substr(0, levelKey.size()) != levelKey)
+            {
+                return false;
+            }
+            rest.remove_prefix(levelKey.size());
+            auto quote = rest.find('"');
+            if (quote == std::string_view::npos)
+            {
+                return false;
+            }
+            level = spdlog::level::from_str(std::string(rest.substr(0, quote)));
+            return true;
+        }
+    } // namespace
+
+    JsonLogQuery::JsonLogQuery(std::string directory) : m_directory(std::move(directory))
+    {
+    }
+
+    std::vector<std::string> JsonLogQuery::query(const JsonLogFilter &filter) const
+    {
+        std::vector<std::string> out;
+        std::vector<int64_t> segments;
+        std::error_code ec;
+        for (const auto &entry : std::filesystem::directory_iterator(m_directory, ec))
+        {
+            auto stem = entry.path().stem().string();
+            if (entry.path().extension() == JsonSegmentSink_mt::kSegmentExt && !stem.empty() &&
+                std::all_of(stem.begin(), stem.end(), [](unsigned char c) { return std::isdigit(c) != 0; }))
+            {
+                segments.push_back(std::stoll(stem));
+            }
+        }
+        std::sort(segments.begin(), segments.end());
+
+        const uint32_t wantMask = levelMaskFrom(filter.minLevel);
+        for (std::size_t i = 0; i < segments.size() && out.size() < filter.limit; ++i)
+        {
+            // 段名为首条记录时间，之后的段只会更晚
+            if (segments[i] > filter.toUs)
+            {
+                break;
+            }
+            if (i + 1 < segments.size() && segments[i + 1] < filter.fromUs)
+            {
+                continue;
+            }
+            auto base = m_directory + "/" + std::to_string(segments[i]);
+            std::FILE *seg = nullptr;
+            if (spdlog::details::os::fopen_s(&seg, base + std::string(JsonSegmentSink_mt::kSegmentExt), "rb"))
+            {
+                continue;
+            }
+
+            std::vector<JsonLogIndexEntry> index;
+            std::FILE *idx = nullptr;
+            if (!spdlog::details::os::fopen_s(&idx, base + std::string(JsonSegmentSink_mt::kIndexExt), "rb"))
+            {
+                JsonLogIndexEntry entry{};
+                while (std::fread(&entry, sizeof(entry), 1, idx) == 1)
+                {
+                    index.push_back(entry);
+                }
+                std::fclose(idx);
+            }
+
+            uint64_t indexedEnd = 0;
+            for (const auto &entry : index)
+            {
+                indexedEnd = std::max<uint64_t>(indexedEnd, entry.offset + entry.length);
+                if (entry.maxTs < filter.fromUs || entry.minTs > filter.toUs || (entry.levelMask & wantMask) == 0)
+                {
+                    continue;
+                }
+                if (!scanRange(seg, entry.offset, entry.length, filter, out))
+                {
+                    break;
+                }
+            }
+
+            // 活动段尾部尚未生成索引的记录
+            uint64_t fileSize = spdlog::details::os::filesize(seg);
+            if (out.size() < filter.limit && fileSize > indexedEnd)
+            {
+                scanRange(seg, indexedEnd, fileSize - indexedEnd, filter, out);
+            }
+            std::fclose(seg);
+        }
+        return out;
+    }
+
+    std::string JsonLogQuery::queryAsJsonArray(const JsonLogFilter &filter) const
+    {
+        auto lines = query(filter);
+        std::size_t total = 2;
+        for (const auto &line : lines)
+        {
+            total += line.size() + 1;
+        }
+        std::string body;
+        body.reserve(total);
+        body.push_back('[');
+        for (std::size_t i = 0; i < lines.size(); ++i)
+        {
+            if (i > 0)
+            {
+                body.push_back(',');
+            }
+            body.append(lines[i]);
+        }
+        body.push_back(']');
+        return body;
+    }
+
+    bool JsonLogQuery::scanRange(std::FILE *fp,
+                                 uint64_t offset,
+                                 uint64_t length,
+                                 const JsonLogFilter &filter,
+                                 std::vector<std::string> &out) const
+    {
+        if (!seekTo(fp, offset))
+        {
+            return false;
+        }
+        std::string buffer(length, '\0');
+        buffer.resize(std::fread(buffer.data(), 1, length, fp));
+
+        std::string_view view(buffer);
+        while (!view.empty())
+        {
+            auto eol = view.find('\n');
+            if (eol == std::string_view::npos)
+            {
+                break; // 写入中的半行
+            }
+            auto line = view.substr(0, eol);
+            view.remove_prefix(eol + 1);
+
+            int64_t ts = 0;
+            spdlog::level::level_enum level = spdlog::level::trace;
+            if (!parseHead(line, ts, level))
+            {
+                continue;
+            }
+            if (ts < filter.fromUs || ts > filter.toUs || level < filter.minLevel)
+            {
+                continue;
+            }
+            out.emplace_back(line);
+            if (out.size() >= filter.limit)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+} // namespace _Kits
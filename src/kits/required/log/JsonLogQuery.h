@@ -0,0 +1,46 @@
+#pragma once
+#include <cstdint>
+#include <cstdio>
+#include <spdlog/common.h>
+#include <string>
+#include <vector>
+
+namespace _Kits
+{
+/**
+ * @brief 结构化日志查询条件。
+ */
+struct JsonLogFilter
+{
+    int64_t fromUs = 0;                                        // 起始时间（epoch 微秒，含）
+    int64_t toUs = INT64_MAX;                                  // 结束时间（epoch 微秒，含）
+    spdlog::level::level_enum minLevel = spdlog::level::trace; // 最低级别
+    std::size_t limit = 1000;                                  // 最多返回条数
+};
+
+/**
+ * @brief 基于 JsonSegmentSink 段文件的查询接口。
+ *
+ * 按段文件名（首条记录时间）与稀疏索引定位数据块，直接 seek 读取命中块，
+ * 不扫描整个文件。活动段尾部尚未写入索引的记录按行扫描。
+ */
+class JsonLogQuery
+{
+  public:
+    explicit JsonLogQuery(std::string directory);
+
+    /// @brief 按写入顺序（近似时间升序）返回匹配的原始 JSON 行，不含换行符
+    std::vector<std::string> query(const JsonLogFilter &filter) const;
+
+    /// @brief 将 query 结果拼成 JSON 数组文本，便于直接作为 HTTP 响应体
+    std::string queryAsJsonArray(const JsonLogFilter &filter) const;
+
+  private:
+    bool scanRange(std::FILE *fp,
+                   uint64_t offset,
+                   uint64_t length,
+                   const JsonLogFilter &filter,
+                   std::vector<std::string> &out) const;
+    std::string m_directory;
+};
+} // namespace _Kits
@@ -0,0 +1,304 @@
+#pragma once
+#include "LogFields.h"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <filesystem>
+#include <mutex>
+#include <spdlog/details/null_mutex.h>
+#include <spdlog/details/os.h>
+#include <spdlog/sinks/base_sink.h>
+#include <string>
+#include <string_view>
+
+namespace _Kits
+{
+/**
+ * @brief 段文件的稀疏时间索引项，每个数据块（若干条记录）一项。
+ *
+ * 索引文件（.idx）与段文件（.ndjson）同名，由定长的索引项顺序组成。
+ * 查询时先按时间范围和级别掩码跳过整块，再在命中块内逐行过滤。
+ */
+struct JsonLogIndexEntry
+{
+    int64_t minTs;      // 块内最早记录时间（epoch 微秒）
+    int64_t maxTs;      // 块内最晚记录时间（epoch 微秒）
+    uint64_t offset;    // 块在段文件中的起始偏移
+    uint32_t length;    // 块字节数
+    uint32_t levelMask; // 块内出现过的级别，bit = 1 << level
+};
+static_assert(sizeof(JsonLogIndexEntry) == 32, "index entry layout changed");
+
+/**
+ * @brief 结构化日志 sink，按行写入 JSON（NDJSON）分段文件并维护稀疏时间索引。
+ *
+ * 每行格式：
+ * {"ts":<epoch_us>,"level":"info","module":"database","source":"SqlInsert.h:42",
+ *  "func":"exec","thread":1234,"msg":"...","kv":{"task_id":"42"}}
+ * ts 固定为首个字段，查询时无需完整解析 JSON 即可取得时间。
+ */
+template <typename Mutex>
+class JsonSegmentSink final : public spdlog::sinks::base_sink<Mutex>
+{
+  public:
+    static constexpr std::string_view kSegmentExt = ".ndjson";
+    static constexpr std::string_view kIndexExt = ".idx";
+
+    JsonSegmentSink(std::string directory,
+                    std::size_t maxSegmentSize = 16 * 1024 * 1024,
+                    std::size_t maxSegments = 64,
+                    std::size_t blockSize = 64 * 1024)
+        : m_directory(std::move(directory)), m_max_segment_size(maxSegmentSize),
+          m_max_segments(maxSegments), m_block_size(blockSize)
+    {
+        if (maxSegmentSize == 0 || blockSize == 0)
+        {
+            spdlog::throw_spdlog_ex(
+                "JsonSegmentSink constructor: sizes cannot be zero");
+        }
+        std::filesystem::create_directories(m_directory);
+        for (const auto &entry : std::filesystem::directory_iterator(m_directory))
+        {
+            auto stem = entry.path().stem().string();
+            if (entry.path().extension() == kSegmentExt && !stem.empty() &&
+                std::all_of(stem.begin(), stem.end(), [](unsigned char c) { return std::isdigit(c) != 0; }))
+            {
+                m_segments.push_back(stem);
+            }
+        }
+        std::sort(m_segments.begin(), m_segments.end(), [](const auto &a, const auto &b) {
+            return std::stoll(a) < std::stoll(b);
+        });
+    }
+
+    ~JsonSegmentSink()
+    {
+        close_();
+    }
+
+    const std::string &directory() const
+    {
+        return m_directory;
+    }
+
+  protected:
+    void sink_it_(const spdlog::details::log_msg &msg) override
+    {
+        auto ts = std::chrono::duration_cast<std::chrono::microseconds>(
+                      msg.time.time_since_epoch())
+                      .count();
+        if (m_segment == nullptr || m_segment_size >= m_max_segment_size)
+        {
+            rotate_(ts);
+        }
+
+        m_line.clear();
+        format_(msg, ts, m_line);
+        if (std::fwrite(m_line.data(), 1, m_line.size(), m_segment) != m_line.size())
+        {
+            spdlog::throw_spdlog_ex("JsonSegmentSink: failed writing segment", errno);
+        }
+
+        if (m_block.length == 0)
+        {
+            m_block.minTs = ts;
+            m_block.maxTs = ts;
+            m_block.offset = m_segment_size;
+            m_block.levelMask = 0;
+        }
+        m_block.minTs = std::min<int64_t>(m_block.minTs, ts);
+        m_block.maxTs = std::max<int64_t>(m_block.maxTs, ts);
+        m_block.levelMask |= 1u << static_cast<uint32_t>(msg.level);
+        m_block.length += static_cast<uint32_t>(m_line.size());
+        m_segment_size += m_line.size();
+        if (m_block.length >= m_block_size)
+        {
+            close_block_();
+        }
+    }
+
+    void flush_() override
+    {
+        if (m_segment)
+        {
+            std::fflush(m_segment);
+        }
+        if (m_index)
+        {
+            std::fflush(m_index);
+        }
+    }
+
+  private:
+    void rotate_(int64_t ts)
+    {
+        close_();
+        auto stem = std::to_string(ts);
+        auto base = m_directory + "/" + stem;
+        if (spdlog::details::os::fopen_s(&m_segment, base + std::string(kSegmentExt), "ab") ||
+            spdlog::details::os::fopen_s(&m_index, base + std::string(kIndexExt), "ab"))
+        {
+            close_();
+            spdlog::throw_spdlog_ex("JsonSegmentSink: failed opening segment " + base, errno);
+        }
+        m_segment_size = spdlog::details::os::filesize(m_segment);
+        m_segments.push_back(stem);
+        while (m_segments.size() > m_max_segments)
+        {
+            std::error_code ec;
+            auto oldest = m_directory + "/" + m_segments.front();
+            std::filesystem::remove(oldest + std::string(kSegmentExt), ec);
+            std::filesystem::remove(oldest + std::string(kIndexExt), ec);
+            m_segments.pop_front();
+        }
+    }
+
+    void close_block_()
+    {
+        if (m_block.length == 0 || m_index == nullptr)
+        {
+            return;
+        }
+        std::fwrite(&m_block, sizeof(m_block), 1, m_index);
+        m_block.length = 0;
+    }
+
+    void close_()
+    {
+        close_block_();
+        if (m_segment)
+        {
+            std::fclose(m_segment);
+            m_segment = nullptr;
+        }
+        if (m_index)
+        {
+            std::fclose(m_index);
+            m_index = nullptr;
+        }
+    }
+
+    static void append_(spdlog::memory_buf_t &buf, std::string_view sv)
+    {
+        buf.append(sv.data(), sv.data() + sv.size());
+    }
+
+    static void append_escaped_(spdlog::memory_buf_t &buf, std::string_view sv)
+    {
+        static constexpr char hex[] = "0123456789abcdef";
+        buf.push_back('"');
+        for (char c : sv)
+        {
+            switch (c)
+            {
+            case '"':
+                append_(buf, "\\\"");
+                break;
+            case '\\':
+                append_(buf, "\\\\");
+                break;
+            case '\n':
+                append_(buf, "\\n");
+                break;
+            case '\r':
+                append_(buf, "\\r");
+                break;
+            case '\t':
+                append_(buf, "\\t");
+                break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20)
+                {
+                    append_(buf, "\\u00");
+                    buf.push_back(hex[(c >> 4) & 0xF]);
+                    buf.push_back(hex[c & 0xF]);
+                }
+                else
+                {
+                    buf.push_back(c);
+                }
+            }
+        }
+        buf.push_back('"');
+    }
+
+    // 取源文件所在目录名作为模块名，如 kits/database/SqlInsert.h -> database
+    static std::string_view module_of_(std::string_view path)
+    {
+        auto end = path.find_last_of("/\\");
+        if (end == std::string_view::npos || end == 0)
+        {
+            return {};
+        }
+        auto begin = path.find_last_of("/\\", end - 1);
+        begin = (begin == std::string_view::npos) ? 0 : begin + 1;
+        return path.substr(begin, end - begin);
+    }
+
+    static std::string_view basename_of_(std::string_view path)
+    {
+        auto pos = path.find_last_of("/\\");
+        return pos == std::string_view::npos ? path : path.substr(pos + 1);
+    }
+
+    static void format_(const spdlog::details::log_msg &msg,
+                        int64_t ts,
+                        spdlog::memory_buf_t &buf)
+    {
+        append_(buf, "{\"ts\":");
+        spdlog::fmt_lib::format_to(std::back_inserter(buf), "{}", ts);
+        append_(buf, ",\"level\":");
+        auto level = spdlog::level::to_string_view(msg.level);
+        append_escaped_(buf, std::string_view(level.data(), level.size()));
+        if (!msg.source.empty())
+        {
+            std::string_view file(msg.source.filename);
+            append_(buf, ",\"module\":");
+            append_escaped_(buf, module_of_(file));
+            append_(buf, ",\"source\":\"");
+            append_(buf, basename_of_(file));
+            spdlog::fmt_lib::format_to(std::back_inserter(buf), ":{}\"", msg.source.line);
+            append_(buf, ",\"func\":");
+            append_escaped_(buf, msg.source.funcname ? msg.source.funcname : "");
+        }
+        spdlog::fmt_lib::format_to(std::back_inserter(buf), ",\"thread\":{}", msg.thread_id);
+        append_(buf, ",\"msg\":");
+        append_escaped_(buf, std::string_view(msg.payload.data(), msg.payload.size()));
+        const auto &kvs = LogFields::current();
+        if (!kvs.empty())
+        {
+            append_(buf, ",\"kv\":{");
+            for (std::size_t i = 0; i < kvs.size(); ++i)
+            {
+                if (i > 0)
+                {
+                    buf.push_back(',');
+                }
+                append_escaped_(buf, kvs[i].first);
+                buf.push_back(':');
+                append_escaped_(buf, kvs[i].second);
+            }
+            buf.push_back('}');
+        }
+        append_(buf, "}\n");
+    }
+
+  private:
+    std::string m_directory;
+    std::size_t m_max_segment_size;
+    std::size_t m_max_segments;
+    std::size_t m_block_size;
+    std::size_t m_segment_size = 0;
+    std::deque<std::string> m_segments;
+    std::FILE *m_segment = nullptr;
+    std::FILE *m_index = nullptr;
+    JsonLogIndexEntry m_block{};
+    spdlog::memory_buf_t m_line;
+};
+
+using JsonSegmentSink_mt = JsonSegmentSink<std::mutex>;
+using JsonSegmentSink_st = JsonSegmentSink<spdlog::details::null_mutex>;
+} // namespace _Kits
@@ -0,0 +1,6 @@
+#pragma once
+#include <QLoggingCategory>
+
+// 框架内 Qt 日志分类，配合 qCDebug/qCWarning 使用。
+// 分类被过滤器关闭时，qCDebug 等宏只做一次布尔判断，不会构造 QDebug 流。
+Q_DECLARE_LOGGING_CATEGORY(tisNetwork)
@@ -0,0 +1,53 @@
+#pragma once
+#include <initializer_list>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace _Kits
+{
+/**
+ * @brief 结构化日志的键值上下文。
+ *
+ * 在作用域内记录的所有日志都会附带这些键值（仅结构化 sink 输出），
+ * 作用域结束自动移除。上下文按线程保存，互不影响。
+ *
+ * @code
+ * LogFields fields{{"task_id", "42"}, {"line", "L3"}};
+ * LogInfo("radar frame stored");
+ * @endcode
+ */
+class LogFields
+{
+  public:
+    using KeyValues = std::vector<std::pair<std::string, std::string>>;
+
+    LogFields(std::initializer_list<std::pair<std::string, std::string>> kvs)
+        : m_count(kvs.size())
+    {
+        auto &ctx = context();
+        ctx.insert(ctx.end(), kvs.begin(), kvs.end());
+    }
+    ~LogFields()
+    {
+        auto &ctx = context();
+        ctx.resize(ctx.size() - m_count);
+    }
+    LogFields(const LogFields &) = delete;
+    LogFields &operator=(const LogFields &) = delete;
+
+    static const KeyValues &current()
+    {
+        return context();
+    }
+
+  private:
+    static KeyValues &context()
+    {
+        thread_local KeyValues kvs;
+        return kvs;
+    }
+
+    std::size_t m_count;
+};
+} // namespace _Kits
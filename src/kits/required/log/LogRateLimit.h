@@ -0,0 +1,201 @@
+#pragma once
+#include "CRossLogger.h"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string_view>
+
+namespace _Kits
+{
+/**
+ * @brief 单个调用点的限频状态，由 LOG_EVERY_* 宏在调用点处定义为静态变量。
+ */
+struct LogRateState
+{
+    std::atomic<uint64_t> counter{0};    // LOG_EVERY_N 调用计数
+    std::atomic<int64_t> nextMs{0};      // 下次允许输出的时间（steady 毫秒）
+    std::atomic<uint64_t> suppressed{0}; // 上次输出后被抑制的条数
+};
+
+/**
+ * @brief LOG_DEDUP_MS 调用点的去重状态：按消息哈希各自计时，
+ * 同一调用点交替输出的不同内容（如多个连接各自的地址）互不影响。
+ */
+struct LogDedupState
+{
+    static constexpr std::size_t kSlots = 16; // 同时跟踪的不同消息数，超出时替换最早到期的
+    struct Slot
+    {
+        uint64_t hash = 0;
+        int64_t nextMs = 0;
+        uint64_t suppressed = 0;
+    };
+    std::mutex mutex;
+    std::array<Slot, kSlots> slots{};
+};
+
+namespace detail
+{
+    inline int64_t steadyMs() noexcept
+    {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(
+                   std::chrono::steady_clock::now().time_since_epoch())
+            .count();
+    }
+
+    inline bool shouldLog(spdlog::level::level_enum level)
+    {
+        CRossLogger::getLogger();
+        return spdlog::should_log(level);
+    }
+
+    // 第 1、n+1、2n+1... 次调用输出
+    inline bool passEveryN(LogRateState &state, uint64_t n, uint64_t &suppressed) noexcept
+    {
+        const uint64_t count = state.counter.fetch_add(1, std::memory_order_relaxed);
+        if (n > 1 && count % n != 0)
+        {
+            return false;
+        }
+        suppressed = (count == 0 || n <= 1) ? 0 : n - 1;
+        return true;
+    }
+
+    // 每个时间窗口最多输出一次，多线程竞争时只有一个线程胜出
+    inline bool passEveryMs(LogRateState &state, int64_t periodMs, uint64_t &suppressed) noexcept
+    {
+        const int64_t now = steadyMs();
+        int64_t next = state.nextMs.load(std::memory_order_relaxed);
+        if (now < next || !state.nextMs.compare_exchange_strong(next, now + periodMs, std::memory_order_relaxed))
+        {
+            state.suppressed.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        suppressed = state.suppressed.exchange(0, std::memory_order_relaxed);
+        return true;
+    }
+
+    // 不能命名为 emit：Qt 把 emit 定义为空宏
+    inline void writeRated(const SourceLocation &location,
+                     spdlog::level::level_enum level,
+                     std::string_view message,
+                     uint64_t suppressed)
+    {
+        auto loc = CRossLogger::getLogger().getLogSourceLocation(location);
+        if (suppressed == 0)
+        {
+            spdlog::log(loc, level, "{}", message);
+        }
+        else
+        {
+            spdlog::log(loc, level, "{} [suppressed {} similar]", message, suppressed);
+        }
+    }
+
+    template <typename... Args>
+    void logRated(const SourceLocation &location,
+                  spdlog::level::level_enum level,
+                  uint64_t suppressed,
+                  fmt::format_string<Args...> fmt,
+                  Args &&...args)
+    {
+        fmt::memory_buffer buf;
+        fmt::format_to(std::back_inserter(buf), fmt, std::forward<Args>(args)...);
+        writeRated(location, level, std::string_view(buf.data(), buf.size()), suppressed);
+    }
+
+    // 同一调用点在窗口期内重复出现相同内容时抑制；不同内容各自计时
+    template <typename... Args>
+    void logDedup(LogDedupState &state,
+                  int64_t windowMs,
+                  const SourceLocation &location,
+                  spdlog::level::level_enum level,
+                  fmt::format_string<Args...> fmt,
+                  Args &&...args)
+    {
+        fmt::memory_buffer buf;
+        fmt::format_to(std::back_inserter(buf), fmt, std::forward<Args>(args)...);
+        std::string_view message(buf.data(), buf.size());
+        const uint64_t hash = std::hash<std::string_view>{}(message);
+        const int64_t now = steadyMs();
+        uint64_t suppressed = 0;
+        {
+            std::lock_guard locker(state.mutex);
+            auto *slot = &state.slots.front();
+            for (auto &candidate : state.slots)
+            {
+                if (candidate.hash == hash)
+                {
+                    slot = &candidate;
+                    break;
+                }
+                if (candidate.nextMs < slot->nextMs)
+                {
+                    slot = &candidate;
+                }
+            }
+            if (slot->hash == hash && now < slot->nextMs)
+            {
+                ++slot->suppressed;
+                return;
+            }
+            suppressed = slot->hash == hash ? slot->suppressed : 0;
+            *slot = {hash, now + windowMs, 0};
+        }
+        writeRated(location, level, message, suppressed);
+    }
+} // namespace detail
+} // namespace _Kits
+
+/**
+ * @brief 热点路径的限频日志，按调用点计数，输出时附带被抑制的条数。
+ *
+ * 级别未开启时只做一次级别判断；被抑制时不格式化参数，只有一次原子操作。
+ *
+ * @code
+ * LOG_EVERY_N(spdlog::level::warn, 100, "frame dropped: {}", id);
+ * LOG_EVERY_MS(spdlog::level::err, 1000, "socket error: {}", code);
+ * LOG_DEDUP_MS(spdlog::level::warn, 5000, "db not ready: {}", name); // 内容相同才抑制
+ * @endcode
+ */
+#define LOG_EVERY_N(level, n, ...)                                                                                                         \
+    do                                                                                                                                     \
+    {                                                                                                                                      \
+        if (_Kits::detail::shouldLog(level))                                                                                               \
+        {                                                                                                                                  \
+            static _Kits::LogRateState _logRateState_;                                                                                     \
+            uint64_t _logSuppressed_ = 0;                                                                                                  \
+            if (_Kits::detail::passEveryN(_logRateState_, (n), _logSuppressed_))                                                           \
+            {                                                                                                                              \
+                _Kits::detail::logRated(_Kits::SourceLocation{}, level, _logSuppressed_, __VA_ARGS__);                                     \
+            }                                                                                                                              \
+        }                                                                                                                                  \
+    } while (0)
+
+#define LOG_EVERY_MS(level, periodMs, ...)                                                                                                 \
+    do                                                                                                                                     \
+    {                                                                                                                                      \
+        if (_Kits::detail::shouldLog(level))                                                                                               \
+        {                                                                                                                                  \
+            static _Kits::LogRateState _logRateState_;                                                                                     \
+            uint64_t _logSuppressed_ = 0;                                                                                                  \
+            if (_Kits::detail::passEveryMs(_logRateState_, (periodMs), _logSuppressed_))                                                   \
+            {                                                                                                                              \
+                _Kits::detail::logRated(_Kits::SourceLocation{}, level, _logSuppressed_, __VA_ARGS__);                                     \
+            }                                                                                                                              \
+        }                                                                                                                                  \
+    } while (0)
+
+// 需要比较内容，被抑制时仍会格式化消息（不产生 I/O）
+#define LOG_DEDUP_MS(level, windowMs, ...)                                                                                                 \
+    do                                                                                                                                     \
+    {                                                                                                                                      \
+        if (_Kits::detail::shouldLog(level))                                                                                               \
+        {                                                                                                                                  \
+            static _Kits::LogDedupState _logRateState_;                                                                                    \
+            _Kits::detail::logDedup(_logRateState_, (windowMs), _Kits::SourceLocation{}, level, __VA_ARGS__);                              \
+        }                                                                                                                                  \
+    } while (0)
@@ -2,24 +2,49 @@
 #include <QDateTime>
 #include <QDir>
 #include <QFile>
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <limits>
 #include <fmt/core.h>
 #include <libzippp/libzippp.h>
 #include <mutex>
 #include <spdlog/details/file_helper.h>
+#include <spdlog/details/os.h>
 #include <spdlog/sinks/daily_file_sink.h>
 #include <spdlog/sinks/rotating_file_sink.h>
 
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
 namespace _Kits
 {
+// 落盘策略：控制 fdatasync 的调用时机
+enum class LogSyncPolicy
+{
+    never,     // 只写入内核页缓存，由操作系统决定落盘时机
+    on_rotate, // 文件切换（按天/按大小）时落盘
+    on_flush   // 每次 flush 时落盘（flush_on/flush_every 触发）
+};
+
 template <typename Mutex>
 class PlainTextSink final : public spdlog::sinks::base_sink<Mutex>
 {
   public:
     PlainTextSink(std::string logDirectory,
                   std::size_t maxSize,
+                  LogSyncPolicy syncPolicy = LogSyncPolicy::on_rotate,
+                  std::size_t bufferSize = 256 * 1024,
                   const spdlog::file_event_handlers &eventHandlers = {})
         : m_log_directory(std::move(logDirectory)), m_max_size(maxSize),
-          m_file_helper(eventHandlers)
+          m_buffer_size(bufferSize), m_sync_policy(syncPolicy),
+          m_event_handlers(eventHandlers)
     {
         if (maxSize == 0)
         {
@@ -27,19 +52,29 @@ class PlainTextSink final : public spdlog::sinks::base_sink<Mutex>
                 "PlainTextSink constructor: max_size cannot be zero");
         }
 
-        m_last_rotation_time = QDateTime::currentDateTime();
         m_archive_file_name = m_log_directory + "/collection.zip";
         // archive_and_rotate_();
 
-        m_base_file_name = m_log_directory + generate_timestamped_filename();
-        m_file_helper.open(m_base_file_name);
-        m_current_size = m_file_helper.size();
+        m_buffer.reserve(m_buffer_size);
+        open_(next_file_name_());
+        update_rotation_deadline_();
+    }
+
+    ~PlainTextSink()
+    {
+        try
+        {
+            close_();
+        }
+        catch (...)
+        {
+        }
     }
 
     spdlog::filename_t filename()
     {
-        std::lock_guard lock(m_mutex);
-        return m_file_helper.filename();
+        std::lock_guard<Mutex> lock(spdlog::sinks::base_sink<Mutex>::mutex_);
+        return m_base_file_name;
     }
 
   protected:
@@ -50,37 +85,42 @@ class PlainTextSink final : public spdlog::sinks::base_sink<Mutex>
 
         if (should_rotate_daily_())
         {
-            m_file_helper.flush();
-            m_file_helper.close();
-            //archive_and_rotate_();
-            m_base_file_name =
-                m_log_directory + generate_timestamped_filename();
-            m_file_helper.open(m_base_file_name);
-            m_current_size = 0;
+            rotate_();
         }
 
         auto newSize = m_current_size + formatted.size();
-        if (newSize > m_max_size)
+        if (newSize > m_max_size && m_current_size > 0)
         {
-            m_file_helper.flush();
-            if (m_file_helper.size() > 0)
-            {
-                m_file_helper.close();
-                // archive_and_rotate_();
-                m_base_file_name =
-                    m_log_directory + generate_timestamped_filename();
-                m_file_helper.open(m_base_file_name);
-                m_current_size = 0;
-            }
+            rotate_();
+            newSize = formatted.size();
         }
 
-        m_file_helper.write(formatted);
+        if (m_buffer.size() + formatted.size() > m_buffer_size)
+        {
+            write_buffer_();
+        }
+        if (formatted.size() >= m_buffer_size)
+        {
+            write_(formatted.data(), formatted.size());
+        }
+        else
+        {
+            m_buffer.append(formatted.data(), formatted.data() + formatted.size());
+        }
         m_current_size = newSize;
     }
 
     void flush_() override
     {
-        m_file_helper.flush();
+        write_buffer_();
+        if (m_fd != nullptr)
+        {
+            std::fflush(m_fd);
+            if (m_sync_policy == LogSyncPolicy::on_flush)
+            {
+                sync_();
+            }
+        }
     }
 
   private:
@@ -91,15 +131,186 @@ class PlainTextSink final : public spdlog::sinks::base_sink<Mutex>
             .toStdString();
     }
 
+    // 同一秒内写满而切换时文件名相同，追加序号，保证每次切换都得到新文件
+    std::string next_file_name_()
+    {
+        auto fileName = m_log_directory + generate_timestamped_filename();
+        if (fileName != m_base_file_name && !QFile::exists(QString::fromStdString(fileName)))
+        {
+            return fileName;
+        }
+        const auto stem = fileName.substr(0, fileName.size() - 4); // 去掉 .log
+        for (int seq = 1;; ++seq)
+        {
+            auto candidate = fmt::format("{}_{}.log", stem, seq);
+            if (!QFile::exists(QString::fromStdString(candidate)))
+            {
+                return candidate;
+            }
+        }
+    }
+
+    // 热路径只比较一次单调时钟，跨天时才做时区相关的日期换算
     bool should_rotate_daily_()
+    {
+        if (std::chrono::steady_clock::now() < m_rotation_deadline)
+        {
+            return false;
+        }
+        auto lastDate = m_rotation_date;
+        update_rotation_deadline_();
+        // 系统时间被回拨等情况下提前到期，只刷新截止时间
+        return m_rotation_date != lastDate;
+    }
+
+    void update_rotation_deadline_()
     {
         auto now = QDateTime::currentDateTime();
-        if (m_last_rotation_time.date() != now.date())
+        m_rotation_date = now.date();
+        QDateTime midnight(m_rotation_date.addDays(1), QTime(0, 0));
+        auto msecs = std::max<qint64>(now.msecsTo(midnight), 1);
+        m_rotation_deadline =
+            std::chrono::steady_clock::now() + std::chrono::milliseconds(msecs);
+    }
+
+    void rotate_()
+    {
+        close_();
+        // archive_and_rotate_();
+        open_(next_file_name_());
+    }
+
+    void open_(const spdlog::filename_t &fileName)
+    {
+        if (m_event_handlers.before_open)
+        {
+            m_event_handlers.before_open(fileName);
+        }
+        auto folder = spdlog::details::os::dir_name(fileName);
+        spdlog::details::os::create_dir(folder);
+        if (spdlog::details::os::fopen_s(
+                &m_fd, fileName, SPDLOG_FILENAME_T("ab")))
         {
-            m_last_rotation_time = now;
-            return true;
+            m_fd = nullptr;
+            spdlog::throw_spdlog_ex("PlainTextSink: failed opening file " +
+                                        spdlog::details::os::filename_to_str(
+                                            fileName),
+                                    errno);
         }
-        return false;
+        // 已有用户态缓冲，关闭 stdio 缓冲避免二次拷贝
+        std::setvbuf(m_fd, nullptr, _IONBF, 0);
+        m_base_file_name = fileName;
+        m_current_size = spdlog::details::os::filesize(m_fd);
+        m_written_size = m_current_size;
+        m_reserved_size = m_current_size;
+        preallocate_();
+        if (m_event_handlers.after_open)
+        {
+            m_event_handlers.after_open(fileName, m_fd);
+        }
+    }
+
+    void close_()
+    {
+        if (m_fd == nullptr)
+        {
+            return;
+        }
+        write_buffer_();
+        if (m_sync_policy != LogSyncPolicy::never)
+        {
+            sync_();
+        }
+        release_reserved_();
+        if (m_event_handlers.before_close)
+        {
+            m_event_handlers.before_close(m_base_file_name, m_fd);
+        }
+        std::fclose(m_fd);
+        m_fd = nullptr;
+        if (m_event_handlers.after_close)
+        {
+            m_event_handlers.after_close(m_base_file_name);
+        }
+    }
+
+    void write_buffer_()
+    {
+        if (m_buffer.size() == 0)
+        {
+            return;
+        }
+        write_(m_buffer.data(), m_buffer.size());
+        m_buffer.clear();
+    }
+
+    void write_(const char *data, std::size_t size)
+    {
+        if (m_fd == nullptr)
+        {
+            return;
+        }
+        if (std::fwrite(data, 1, size, m_fd) != size)
+        {
+            spdlog::throw_spdlog_ex("PlainTextSink: failed writing to file " +
+                                        spdlog::details::os::filename_to_str(
+                                            m_base_file_name),
+                                    errno);
+        }
+        m_written_size += size;
+        if (m_written_size >= m_reserved_size)
+        {
+            preallocate_();
+        }
+    }
+
+    // 在写入位置之后分段预留磁盘块（不改变文件长度），减少追加写时的元数据更新
+    void preallocate_()
+    {
+#if defined(__linux__)
+        constexpr std::size_t kStep = 4 * 1024 * 1024;
+        const auto target = std::min(m_written_size + kStep, m_max_size);
+        if (target <= m_reserved_size)
+        {
+            return;
+        }
+        if (::fallocate(::fileno(m_fd),
+                        FALLOC_FL_KEEP_SIZE,
+                        static_cast<off_t>(m_reserved_size),
+                        static_cast<off_t>(target - m_reserved_size)) == 0)
+        {
+            m_reserved_size = target;
+        }
+        else
+        {
+            // 不支持 fallocate 的文件系统不再尝试
+            m_reserved_size = std::numeric_limits<std::size_t>::max();
+        }
+#endif
+    }
+
+    // 关闭前截断到实际长度，释放文件末尾之后未用完的预留块
+    void release_reserved_()
+    {
+#if defined(__linux__)
+        if (m_reserved_size > m_written_size && m_reserved_size != std::numeric_limits<std::size_t>::max())
+        {
+            // 截断失败只会在文件尾留下预分配的零填充区，不影响已写内容；sink 内不能再写日志，直接输出到 stderr
+            if (::ftruncate(::fileno(m_fd), static_cast<off_t>(m_written_size)) != 0)
+            {
+                std::fprintf(stderr, "PlainTextSink: truncate %s failed: %s\n", m_base_file_name.c_str(), std::strerror(errno));
+            }
+        }
+#endif
+    }
+
+    void sync_()
+    {
+#ifdef _WIN32
+        ::_commit(::_fileno(m_fd));
+#else
+        ::fdatasync(::fileno(m_fd));
+#endif
     }
 
     void archive_and_rotate_()
@@ -152,16 +363,22 @@ class PlainTextSink final : public spdlog::sinks::base_sink<Mutex>
     }
 
   private:
-    std::mutex m_mutex;
-    QDateTime m_last_rotation_time;
+    std::chrono::steady_clock::time_point m_rotation_deadline;
+    QDate m_rotation_date;
     std::string m_log_directory;
     std::string m_base_file_name;
     std::string m_archive_file_name;
     std::size_t m_max_size;
-    std::size_t m_current_size;
-    spdlog::details::file_helper m_file_helper;
+    std::size_t m_current_size = 0;  // 含缓冲区中未写出的部分
+    std::size_t m_written_size = 0;  // 已写入文件的长度
+    std::size_t m_reserved_size = 0; // 已预留到的文件偏移
+    std::size_t m_buffer_size;
+    LogSyncPolicy m_sync_policy;
+    spdlog::memory_buf_t m_buffer;
+    std::FILE *m_fd = nullptr;
+    spdlog::file_event_handlers m_event_handlers;
 };
 
 using PlainTextSink_st = PlainTextSink<spdlog::details::null_mutex>;
 using PlainTextSink_mt = PlainTextSink<std::mutex>;
-} // namespace _Kits
\ No newline at end of file
+} // namespace _Kits
@@ -0,0 +1,93 @@
+#include "QtMessageBridge.h"
+#include "CRossLogger.h"
+#include "LogCategories.h"
+#include <QByteArray>
+#include <QString>
+#include <cstring>
+
+Q_LOGGING_CATEGORY(tisNetwork, "tis.network")
+
+namespace _Kits
+{
+    namespace
+    {
+        QLoggingCategory::CategoryFilter previousFilter = nullptr;
+
+        spdlog::level::level_enum toSpdLevel(QtMsgType type)
+        {
+            switch (type)
+            {
+            case QtDebugMsg:
+                return spdlog::level::debug;
+            case QtInfoMsg:
+                return spdlog::level::info;
+            case QtWarningMsg:
+                return spdlog::level::warn;
+            case QtCriticalMsg:
+                return spdlog::level::err;
+            case QtFatalMsg:
+                return spdlog::level::critical;
+            }
+            return spdlog::level::info;
+        }
+
+        // 先保留 Qt 默认规则（如 qt.* 调试分类默认关闭），再按当前日志级别收紧
+        void categoryFilter(QLoggingCategory *category)
+        {
+            if (previousFilter)
+            {
+                previousFilter(category);
+            }
+            auto level = CRossLogger::getLogger().getLogLevel();
+            for (auto type : {QtDebugMsg, QtInfoMsg, QtWarningMsg, QtCriticalMsg})
+            {
+                if (toSpdLevel(type) < level)
+                {
+                    category->setEnabled(type, false);
+                }
+            }
+        }
+
+        void messageHandler(QtMsgType type, const QMessageLogContext &context, const QString &message)
+        {
+            auto level = toSpdLevel(type);
+            auto *logger = spdlog::default_logger_raw();
+            if (logger == nullptr || !logger->should_log(level))
+            {
+                return;
+            }
+            spdlog::source_loc location;
+            if (context.file)
+            {
+                location = spdlog::source_loc{context.file, context.line, context.function};
+            }
+            const QByteArray text = message.toUtf8();
+            std::string_view view(text.constData(), static_cast<size_t>(text.size()));
+            if (context.category && std::strcmp(context.category, "default") != 0)
+            {
+                logger->log(location, level, "[{}] {}", context.category, view);
+            }
+            else
+            {
+                logger->log(location, level, "{}", view);
+            }
+            if (type == QtFatalMsg)
+            {
+                logger->flush();
+            }
+        }
+    } // namespace
+
+    void QtMessageBridge::install()
+    {
+        CRossLogger::getLogger();
+        qInstallMessageHandler(messageHandler);
+        previousFilter = QLoggingCategory::installFilter(categoryFilter);
+    }
+
+    void QtMessageBridge::refreshCategories()
+    {
+        // installFilter 会对已存在的分类重新执行过滤器
+        QLoggingCategory::installFilter(categoryFilter);
+    }
+} // namespace _Kits
@@ -0,0 +1,20 @@
+#pragma once
+
+namespace _Kits
+{
+/**
+ * @brief 将 qDebug/qWarning 等 Qt 日志转发到 CRossLogger。
+ *
+ * - 安装 qInstallMessageHandler，按消息类型映射到 spdlog 级别，
+ *   分类名作为前缀，源码位置透传（需定义 QT_MESSAGELOGCONTEXT）。
+ * - 安装 QLoggingCategory 过滤器，低于当前日志级别的分类直接关闭，
+ *   使用 qCDebug 等分类宏时被关闭的日志不产生格式化开销。
+ */
+class QtMessageBridge
+{
+  public:
+    static void install();
+    /// @brief 日志级别变化后重新应用分类过滤器
+    static void refreshCategories();
+};
+} // namespace _Kits
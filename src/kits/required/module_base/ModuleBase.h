@@ -1,5 +1,6 @@
 #pragma once
 #include "kits/required/factory/ModuleRegister.h"
+#include "kits/required/log/FlightRecorder.h"
 #include <QEventLoop>
 #include <QObject>
 #include <QVariant>
@@ -77,6 +78,7 @@ namespace _Kits
     template <typename... Args>
     inline bool ModuleBase::invokeAsync(const std::string &funcName, Args &&...args)
     {
+        flightEvent(FlightKind::invoke, funcName);
         auto finder = m_mapMetaMethods.find(funcName);
         if (finder == m_mapMetaMethods.end())
         {
@@ -94,6 +96,7 @@ namespace _Kits
     template <typename Ret, typename... Args>
     inline Ret ModuleBase::invokeSync(const std::string &funcName, Args &&...args)
     {
+        flightEvent(FlightKind::invoke, funcName);
         Ret result;
         auto finder = m_mapMetaMethods.find(funcName);
         if (finder == m_mapMetaMethods.end())
@@ -1,7 +1,7 @@
 #include "Utils.h"
 #include <openssl/aes.h>
 #include <openssl/rand.h>
-#include <filesystem>
+#include "kits/required/config/ConfigService.h"
 #include "kits/required/log/CRossLogger.h"
 using namespace _Kits;
 std::vector<std::string> Utils::split(const std::string &str,
@@ -119,17 +119,6 @@ int Utils::decryptAES(const unsigned char *ciphertext,
         return false;
     }
 
-    try
-    {
-        config = YAML::LoadFile(
-            std::filesystem::current_path().string() + str_config_path);
-    }
-    catch(const std::exception& e)
-    {
-        LogError("Failed to load config file: {%s}", e.what());
-        
-        return false;
-    }
-    
-    return true;
+    // 路径相对于程序目录，解析结果由配置服务缓存
+    return ConfigService::instance().loadFile(str_config_path, config);
  }
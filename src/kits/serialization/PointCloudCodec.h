@@ -0,0 +1,312 @@
+// kits_point_cloud_codec.h
+#pragma once
+
+#include <QByteArray>
+#include <QString>
+#include <QtEndian>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <json/json.h>
+#include <limits>
+#include <memory>
+#include <vector>
+
+namespace _Kits
+{
+    struct RadarPoint
+    {
+        float x = 0;
+        float y = 0;
+    };
+
+    struct PointCloudOptions
+    {
+        bool quantize = true;     // 16 位量化，超出量程或含非有限值时退回 float32
+        float precision = 0.001f; // 量化步长，解码误差不超过其一半
+        bool delta = true;        // 量化值按相邻差分存储，连续扫描点差分小，压缩率更高
+        bool compress = true;     // zlib 压缩载荷，压缩后不变小则保留原文
+        int compressMin = 256;    // 载荷小于该字节数时不压缩
+    };
+
+    /**
+     * @brief 雷达点云的二进制列格式，存入 bytea 列，替代 {"points":[{"x":..,"y":..}]} 文本。
+     *
+     * 布局（小端）：
+     * @code
+     * 0  'P' 'C'       魔数
+     * 2  uint8         版本，当前为 1
+     * 3  uint8         标志：bit0 16 位量化，bit1 差分，bit2 zlib 压缩
+     * 4  uint32        点数 n
+     * 8  float32       量化步长（未量化为 0）
+     * 12 float32 x2    量化原点 (x, y)
+     * 20 载荷          x[n] 后接 y[n]（列式），元素为 float32 或 uint16；压缩时为 qCompress 结果
+     * @endcode
+     *
+     * @code
+     * data.points_bin = PointCloudCodec::encode(points);
+     * std::vector<RadarPoint> points;
+     * PointCloudCodec::decode(row.points_bin, points);
+     * @endcode
+     */
+    class PointCloudCodec
+    {
+      public:
+        static constexpr uint8_t kVersion = 1;
+        static constexpr int kHeaderSize = 20;
+        enum Flag : uint8_t
+        {
+            Quantized = 0x01,
+            Delta = 0x02,
+            Compressed = 0x04,
+        };
+
+        static QByteArray encode(const std::vector<RadarPoint> &points, const PointCloudOptions &options = {})
+        {
+            const auto count = static_cast<uint32_t>(points.size());
+            float scale = 0;
+            float originX = 0;
+            float originY = 0;
+            uint8_t flags = 0;
+            if (options.quantize && options.precision > 0 && quantizable(points, options.precision, originX, originY))
+            {
+                scale = options.precision;
+                flags |= Quantized;
+                if (options.delta)
+                {
+                    flags |= Delta;
+                }
+            }
+
+            QByteArray payload;
+            if (flags & Quantized)
+            {
+                payload.resize(static_cast<qsizetype>(count) * 2 * sizeof(uint16_t));
+                auto *xs = reinterpret_cast<uchar *>(payload.data());
+                auto *ys = xs + count * sizeof(uint16_t);
+                uint16_t lastX = 0;
+                uint16_t lastY = 0;
+                for (uint32_t i = 0; i < count; ++i)
+                {
+                    auto qx = static_cast<uint16_t>(std::lround((points[i].x - originX) / scale));
+                    auto qy = static_cast<uint16_t>(std::lround((points[i].y - originY) / scale));
+                    // 差分按 16 位回绕，解码时同样回绕即可还原
+                    qToLittleEndian<uint16_t>((flags & Delta) ? static_cast<uint16_t>(qx - lastX) : qx, xs + i * sizeof(uint16_t));
+                    qToLittleEndian<uint16_t>((flags & Delta) ? static_cast<uint16_t>(qy - lastY) : qy, ys + i * sizeof(uint16_t));
+                    lastX = qx;
+                    lastY = qy;
+                }
+            }
+            else
+            {
+                payload.resize(static_cast<qsizetype>(count) * 2 * sizeof(float));
+                auto *xs = reinterpret_cast<uchar *>(payload.data());
+                auto *ys = xs + count * sizeof(float);
+                for (uint32_t i = 0; i < count; ++i)
+                {
+                    putFloat(xs + i * sizeof(float), points[i].x);
+                    putFloat(ys + i * sizeof(float), points[i].y);
+                }
+            }
+
+            if (options.compress && payload.size() >= options.compressMin)
+            {
+                auto packed = qCompress(payload);
+                if (packed.size() < payload.size())
+                {
+                    payload = std::move(packed);
+                    flags |= Compressed;
+                }
+            }
+
+            QByteArray out(kHeaderSize, '\0');
+            auto *header = reinterpret_cast<uchar *>(out.data());
+            header[0] = 'P';
+            header[1] = 'C';
+            header[2] = kVersion;
+            header[3] = flags;
+            qToLittleEndian<uint32_t>(count, header + 4);
+            putFloat(header + 8, scale);
+            putFloat(header + 12, originX);
+            putFloat(header + 16, originY);
+            out.append(payload);
+            return out;
+        }
+
+        /// @brief 解码，格式或长度不符时返回 false 且不修改 points
+        static bool decode(const QByteArray &data, std::vector<RadarPoint> &points)
+        {
+            if (!isEncoded(data))
+            {
+                return false;
+            }
+            const auto *header = reinterpret_cast<const uchar *>(data.constData());
+            const uint8_t flags = header[3];
+            const uint32_t count = qFromLittleEndian<uint32_t>(header + 4);
+            const float scale = getFloat(header + 8);
+            const float originX = getFloat(header + 12);
+            const float originY = getFloat(header + 16);
+            const std::size_t element = (flags & Quantized) ? sizeof(uint16_t) : sizeof(float);
+            const std::size_t expected = static_cast<std::size_t>(count) * 2 * element;
+
+            QByteArray payload = data.mid(kHeaderSize);
+            if (flags & Compressed)
+            {
+                // qCompress 前 4 字节为大端原始长度，先校验再解压，避免按损坏的长度分配内存
+                if (payload.size() < 4 || qFromBigEndian<uint32_t>(payload.constData()) != expected)
+                {
+                    return false;
+                }
+                payload = qUncompress(payload);
+            }
+            if (static_cast<std::size_t>(payload.size()) != expected)
+            {
+                return false;
+            }
+
+            std::vector<RadarPoint> result(count);
+            const auto *xs = reinterpret_cast<const uchar *>(payload.constData());
+            const auto *ys = xs + count * element;
+            if (flags & Quantized)
+            {
+                uint16_t qx = 0;
+                uint16_t qy = 0;
+                for (uint32_t i = 0; i < count; ++i)
+                {
+                    const auto dx = qFromLittleEndian<uint16_t>(xs + i * element);
+                    const auto dy = qFromLittleEndian<uint16_t>(ys + i * element);
+                    qx = (flags & Delta) ? static_cast<uint16_t>(qx + dx) : dx;
+                    qy = (flags & Delta) ? static_cast<uint16_t>(qy + dy) : dy;
+                    result[i].x = originX + qx * scale;
+                    result[i].y = originY + qy * scale;
+                }
+            }
+            else
+            {
+                for (uint32_t i = 0; i < count; ++i)
+                {
+                    result[i].x = getFloat(xs + i * element);
+                    result[i].y = getFloat(ys + i * element);
+                }
+            }
+            points = std::move(result);
+            return true;
+        }
+
+        static bool isEncoded(const QByteArray &data)
+        {
+            return data.size() >= kHeaderSize && data[0] == 'P' && data[1] == 'C' && static_cast<uint8_t>(data[2]) == kVersion;
+        }
+
+        /// @brief 解析旧的 JSON 文本，支持 {"points":[...]} 与裸数组两种写法
+        static bool fromJson(const QString &text, std::vector<RadarPoint> &points)
+        {
+            const auto utf8 = text.toUtf8();
+            Json::Value root;
+            Json::CharReaderBuilder builder;
+            std::unique_ptr<Json::CharReader> reader(builder.newCharReader());
+            if (!reader->parse(utf8.constData(), utf8.constData() + utf8.size(), &root, nullptr))
+            {
+                return false;
+            }
+            const Json::Value &array = root.isObject() ? root["points"] : root;
+            if (!array.isArray())
+            {
+                return false;
+            }
+            std::vector<RadarPoint> result;
+            result.reserve(array.size());
+            for (const auto &item : array)
+            {
+                if (!item.isObject() || !item["x"].isNumeric() || !item["y"].isNumeric())
+                {
+                    return false;
+                }
+                result.push_back({item["x"].asFloat(), item["y"].asFloat()});
+            }
+            points = std::move(result);
+            return true;
+        }
+
+        /// @brief 读取一行的点云：优先二进制列，为空时回落到尚未迁移的 JSON 文本
+        static bool load(const QByteArray &data, const QString &legacy, std::vector<RadarPoint> &points)
+        {
+            if (!data.isEmpty())
+            {
+                return decode(data, points);
+            }
+            if (legacy.isEmpty())
+            {
+                points.clear();
+                return true;
+            }
+            return fromJson(legacy, points);
+        }
+
+        /// @brief 转回 {"points":[{"x":..,"y":..}]}，供仍按 JSON 读取的页面使用
+        static Json::Value toJson(const std::vector<RadarPoint> &points)
+        {
+            Json::Value root(Json::objectValue);
+            Json::Value &array = root["points"] = Json::Value(Json::arrayValue);
+            for (const auto &point : points)
+            {
+                Json::Value item(Json::objectValue);
+                item["x"] = point.x;
+                item["y"] = point.y;
+                array.append(std::move(item));
+            }
+            return root;
+        }
+
+      private:
+        // 所有点都在 16 位量程内时返回 true，并给出量化原点（各轴最小值）
+        static bool quantizable(const std::vector<RadarPoint> &points, float precision, float &originX, float &originY)
+        {
+            if (points.empty())
+            {
+                return true;
+            }
+            float minX = std::numeric_limits<float>::max();
+            float minY = std::numeric_limits<float>::max();
+            float maxX = std::numeric_limits<float>::lowest();
+            float maxY = std::numeric_limits<float>::lowest();
+            for (const auto &point : points)
+            {
+                if (!std::isfinite(point.x) || !std::isfinite(point.y))
+                {
+                    return false;
+                }
+                minX = std::min(minX, point.x);
+                minY = std::min(minY, point.y);
+                maxX = std::max(maxX, point.x);
+                maxY = std::max(maxY, point.y);
+            }
+            // 留一个步长的余量，避免舍入后越过 65535
+            const double limit = static_cast<double>(precision) * (std::numeric_limits<uint16_t>::max() - 1);
+            if (static_cast<double>(maxX) - minX > limit || static_cast<double>(maxY) - minY > limit)
+            {
+                return false;
+            }
+            originX = minX;
+            originY = minY;
+            return true;
+        }
+
+        static void putFloat(uchar *dst, float value)
+        {
+            uint32_t bits;
+            std::memcpy(&bits, &value, sizeof(bits));
+            qToLittleEndian<uint32_t>(bits, dst);
+        }
+
+        static float getFloat(const uchar *src)
+        {
+            const uint32_t bits = qFromLittleEndian<uint32_t>(src);
+            float value;
+            std::memcpy(&value, &bits, sizeof(value));
+            return value;
+        }
+    };
+
+} // namespace _Kits
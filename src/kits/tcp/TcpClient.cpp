@@ -1,4 +1,7 @@
 #include "TcpClient.h"
+#include "kits/required/log/FlightRecorder.h"
+#include "kits/required/log/LogCategories.h"
+#include "kits/required/log/LogRateLimit.h"
 #include <qtimer.h>
 namespace _Kits
 {
@@ -30,18 +33,18 @@ namespace _Kits
 
         if (tcp_->state() == QAbstractSocket::ConnectedState)
         {
-            qDebug() << "Disconnecting from host...";
+            qCDebug(tisNetwork) << "Disconnecting from host...";
             tcp_->disconnectFromHost();
 
             // 等待对端确认断开（可选）
             if (!tcp_->waitForDisconnected(3000))
             {
-                qDebug() << "Disconnect timeout. Aborting...";
+                qCDebug(tisNetwork) << "Disconnect timeout. Aborting...";
                 tcp_->abort(); // 超时后强制断开
             }
             else
             {
-                qDebug() << "TCP Disconnected successfully.";
+                qCDebug(tisNetwork) << "TCP Disconnected successfully.";
             }
         }
     }
@@ -83,13 +86,13 @@ namespace _Kits
     {
         if (tcp_->state() == QAbstractSocket::UnconnectedState)
         {
-            qDebug() << "connect to ip= " << host_ << ",port=" << port_;
+            qCDebug(tisNetwork) << "connect to ip= " << host_ << ",port=" << port_;
             tcp_->connectToHost(host_, port_);
         }
         else
         {
-            qDebug() << "connect state: " << tcp_->state()
-                     << ",check QAbstractSocket::SocketState";
+            qCDebug(tisNetwork) << "connect state: " << tcp_->state()
+                                << ",check QAbstractSocket::SocketState";
         }
     }
 
@@ -108,14 +111,19 @@ namespace _Kits
     void TcpClient::reconnect()
     {
         // 断开连接后重新连接到服务器
-        qDebug() << "\nreconnect to server";
+        qCDebug(tisNetwork) << "reconnect to server";
         connectToServer();
     }
 
     void TcpClient::onConnected()
     {
         bconnect_ = true;
-        qDebug() << "\nConnected to ip, port: " << host_ << port_;
+        if (FlightRecorder::instance().isOpen())
+        {
+            flightEvent(FlightKind::socket,
+                        QString("tcp connected %1:%2").arg(host_).arg(port_).toStdString());
+        }
+        qCDebug(tisNetwork) << "Connected to ip, port: " << host_ << port_;
         // 连接成功后停止重连计时器
         if (reconnectTimer_ && reconnectTimer_->isActive())
             reconnectTimer_->stop();
@@ -124,6 +132,11 @@ namespace _Kits
     void TcpClient::onDisconnected()
     {
         bconnect_ = false;
+        if (FlightRecorder::instance().isOpen())
+        {
+            flightEvent(FlightKind::socket,
+                        QString("tcp disconnected %1:%2").arg(host_).arg(port_).toStdString());
+        }
         // 断开连接后启动重连计时器
         if (reconnectTimer_ && !reconnectTimer_->isActive())
             reconnectTimer_->start();
@@ -132,8 +145,18 @@ namespace _Kits
     void TcpClient::onError(QAbstractSocket::SocketError errCode)
     {
         bconnect_ = false;
-        qDebug() << "\nSocket error: " << errCode
-                 << ", check QAbstractSocket::SocketError";
+        if (FlightRecorder::instance().isOpen())
+        {
+            flightEvent(FlightKind::socket,
+                        QString("tcp error %1:%2 code=%3").arg(host_).arg(port_).arg(errCode).toStdString());
+        }
+        // 重连风暴时每个地址同类错误每 5 秒最多输出一次
+        LOG_DEDUP_MS(spdlog::level::warn,
+                     5000,
+                     "Socket error: {}:{} code={}, check QAbstractSocket::SocketError",
+                     host_.toStdString(),
+                     port_,
+                     static_cast<int>(errCode));
         // 发生错误后启动重连计时器
         if (reconnectTimer_ && !reconnectTimer_->isActive())
             reconnectTimer_->start();
@@ -40,7 +40,7 @@ namespace _Modules
                     auto jsData = m_ptrDevice->logicalDriveInfo();
                     QVariantMap mapData;
                     mapData[TIS_Info::QmlCommunication::strForQmlSignals] = QVariant::fromValue(TIS_Info::QmlCommunication::ForQmlSignals::main_page);
-                    mapData[TIS_Info::QmlCommunication::strData] = QVariant();
+                    mapData[TIS_Info::QmlCommunication::strData] = jsData;
                     emit notifyDiskInfo(mapData);
                 },
                 5000);
@@ -1,7 +1,10 @@
 #include "AppFrameworkImpl.h"
+#include "kits/required/config/ConfigService.h"
 #include "kits/required/factory/ControllerRegister.h"
 #include "kits/required/factory/ModuleRegister.h"
+#include "kits/required/factory/StartupRegister.h"
 #include "kits/required/log/CRossLogger.h"
+#include "kits/required/log/QtMessageBridge.h"
 #include "kits/required/module_base/ModuleBase.h"
 #include "kits/required/thread_pool/ConcurrentPool.h"
 #include <QApplication>
@@ -29,10 +32,14 @@ AppFrameworkImpl::~AppFrameworkImpl() noexcept
 }
 int AppFrameworkImpl::run(int argc, char *argv[])
 {
+    QtMessageBridge::install(); // qDebug/qWarning 统一进入日志系统
     QApplication qtCore(argc, argv);
     qtCore.setWindowIcon(QIcon(":/infinity_station/res/icon/gw.ico")); // 设置标题栏图标
     auto config = loadConfig();
+    // kit 的启动钩子（如数据库建库与连接预热）依赖 QApplication 与配置，在创建模块前触发
+    StartupRegister::runAll();
     createModules(config);
+    LogInfo("startup: modules created in {} ms", StartupRegister::mark("modules_created"));
     cmdCheck();
 
     int ret = qtCore.exec();
@@ -41,18 +48,16 @@ int AppFrameworkImpl::run(int argc, char *argv[])
 }
 YAML::Node AppFrameworkImpl::loadConfig()
 {
-    YAML::Node config;
-    try
-    {
-        std::string filePath = QCoreApplication::applicationDirPath().toStdString() + "/config/config.yaml";
-        config = YAML::LoadFile(filePath);
-    }
-    catch (const YAML::Exception &e)
+    auto &service = ConfigService::instance();
+    auto config = service.snapshot();
+    if (!config->valid)
     {
         qDebug() << "Error: Loaded YAML is null (invalid or empty file).";
         std::terminate();
     }
-    return config;
+    service.watch(); // 配置文件变更时热更新快照
+    // 模块可能修改拿到的节点，交出副本；YAML::Node 赋值与非 const 访问会改动快照中共享的树
+    return YAML::Clone(config->root);
 }
 void AppFrameworkImpl::stop() noexcept
 {
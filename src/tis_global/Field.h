@@ -21,6 +21,11 @@ namespace TIS_Info
             constexpr char database_select[] = "/database/select";
             constexpr char database_insert[] = "/database/insert";
             constexpr char api_communication[] = "/api/communication";
+            constexpr char log_query[] = "/log/query";
+            constexpr char log_bench[] = "/log/bench";
+            constexpr char database_stats[] = "/database/stats";
+            constexpr char database_bench[] = "/database/bench";
+            constexpr char device_status[] = "/device/status";
         } // namespace HttpRoutes
     } // namespace HttpService
 } // namespace TIS_Info
\ No newline at end of file
@@ -0,0 +1,132 @@
+// 读取 FlightRecorder 记录文件（flight.rec / flight.rec.prev），按时间顺序输出。
+// 用法：flight_reader <flight.rec> [--last N]
+#include "kits/required/log/FlightRecorderLayout.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace _Kits;
+
+namespace
+{
+    const char *kindName(uint8_t kind)
+    {
+        switch (static_cast<FlightKind>(kind))
+        {
+        case FlightKind::log:
+            return "log";
+        case FlightKind::invoke:
+            return "invoke";
+        case FlightKind::database:
+            return "database";
+        case FlightKind::socket:
+            return "socket";
+        }
+        return "unknown";
+    }
+
+    const char *levelName(uint8_t level)
+    {
+        static const char *names[] = {"trace", "debug", "info", "warn", "error", "critical", "off"};
+        return level < 7 ? names[level] : "?";
+    }
+
+    std::string formatTime(int64_t us)
+    {
+        std::time_t sec = static_cast<std::time_t>(us / 1000000);
+        std::tm tm{};
+#ifdef _WIN32
+        localtime_s(&tm, &sec);
+#else
+        localtime_r(&sec, &tm);
+#endif
+        char buf[64];
+        std::strftime(buf, sizeof(buf), "%Y-%m-%d %H:%M:%S", &tm);
+        char out[80];
+        std::snprintf(out, sizeof(out), "%s.%06lld", buf, static_cast<long long>(us % 1000000));
+        return out;
+    }
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    if (argc < 2)
+    {
+        std::cerr << "usage: flight_reader <flight.rec> [--last N]\n";
+        return 1;
+    }
+    std::size_t last = 0;
+    for (int i = 2; i + 1 < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--last") == 0)
+        {
+            last = std::stoul(argv[i + 1]);
+        }
+    }
+
+    std::ifstream file(argv[1], std::ios::binary);
+    if (!file)
+    {
+        std::cerr << "cannot open " << argv[1] << "\n";
+        return 1;
+    }
+    std::vector<char> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    if (data.size() < sizeof(FlightHeader))
+    {
+        std::cerr << "file too small\n";
+        return 1;
+    }
+
+    const auto *header = reinterpret_cast<const FlightHeader *>(data.data());
+    if (header->magic != kFlightMagic || header->version != kFlightVersion || header->slotSize != kFlightSlotSize)
+    {
+        std::cerr << "not a flight recorder file (or unsupported version)\n";
+        return 1;
+    }
+    const std::size_t expected = sizeof(FlightHeader) + std::size_t(header->slotCount) * sizeof(FlightSlot);
+    if (data.size() < expected)
+    {
+        std::cerr << "file truncated\n";
+        return 1;
+    }
+
+    const uint64_t next = header->next.load();
+    std::cout << "pid=" << header->pid << " started=" << formatTime(header->startUs) << " records=" << next
+              << " slots=" << header->slotCount << "\n";
+
+    // 只保留提交完整、且序号与槽位一致的记录；写入中被中断的槽位会被跳过
+    const auto *slots = reinterpret_cast<const FlightSlot *>(data.data() + sizeof(FlightHeader));
+    std::vector<const FlightSlot *> valid;
+    for (uint32_t i = 0; i < header->slotCount; ++i)
+    {
+        const uint64_t seq = slots[i].seq.load();
+        if (seq != 0 && (seq - 1) % header->slotCount == i)
+        {
+            valid.push_back(&slots[i]);
+        }
+    }
+    std::sort(valid.begin(), valid.end(), [](const FlightSlot *a, const FlightSlot *b) {
+        return a->seq.load() < b->seq.load();
+    });
+    if (last > 0 && valid.size() > last)
+    {
+        valid.erase(valid.begin(), valid.end() - static_cast<std::ptrdiff_t>(last));
+    }
+
+    for (const auto *slot : valid)
+    {
+        std::string text(slot->text, std::min<std::size_t>(slot->length, sizeof(slot->text)));
+        std::cout << "#" << slot->seq.load() - 1 << " " << formatTime(slot->tsUs) << " [" << kindName(slot->kind) << "]";
+        if (static_cast<FlightKind>(slot->kind) == FlightKind::log)
+        {
+            std::cout << "[" << levelName(slot->level) << "]";
+        }
+        std::cout << "[tid " << slot->thread << "] " << text << "\n";
+    }
+    return 0;
+}